@@ -2,6 +2,13 @@
 #define BACKTESTING_HPP
 
 #include "Common.hpp"
+#include "Date.hpp"
+#include "SymbolTable.hpp"
+#include "TradingCalendar.hpp"
+#include "PerformanceMetrics.hpp"
+#include "TextBuffer.hpp"
+#include <array>
+#include <type_traits>
 
 class BackTesting {
 public:
@@ -16,11 +23,54 @@ public:
     // Virtual method for running back-tests
     virtual void run() = 0;
 
-    // Performance metrics
+    // Performance metrics; Sharpe ratio and drawdown are per trade and read from the running metrics
     double calculateCumulativeReturn() const;
     double calculateSharpeRatio() const;
     double calculateMaximumDrawdown() const;
 
+    // Running metrics, per trade and per session, updated as the back-test runs
+    const PerformanceMetrics& getMetrics() const;
+
+	// Legs of every trade
+	static constexpr std::size_t LEG_COUNT = 2;
+
+	// Plain trade record; dates and symbols are resolved to text only when written
+	struct Trade {
+		std::uint32_t entrySession;                             // Session index in the calendar, see getSessionDate
+		std::uint32_t exitSession;                              // Session index in the calendar, see getSessionDate
+		std::array<SymbolTable::SymbolId, LEG_COUNT> symbols;   // Ids in the symbols table, see getSymbolName
+		std::array<double, LEG_COUNT> entryPrices;              // Aligned with symbols
+		std::array<double, LEG_COUNT> exitPrices;               // Aligned with symbols
+		double profitLoss;
+	};
+	static_assert(std::is_trivially_copyable<Trade>::value, "Trade records must stay plain data");
+
+	// Trades in the order they were closed, with the session dates and symbol names they refer to
+	const std::vector<Trade>& getTrades() const;
+	Date getSessionDate(std::uint32_t session) const;
+	const std::string& getSymbolName(SymbolTable::SymbolId symbol) const;
+
+	// Trade with its sessions resolved to dates, so it can outlive the back-test; legs as in Trade
+	struct TradeRow {
+		Date entryDate;
+		Date exitDate;
+		std::array<double, LEG_COUNT> entryPrices;
+		std::array<double, LEG_COUNT> exitPrices;
+		double profitLoss;
+	};
+	static_assert(std::is_trivially_copyable<TradeRow>::value, "Trade rows must stay plain data");
+
+	// Method to resolve the sessions of a trade of this back-test
+	TradeRow resolveTrade(const Trade& trade) const;
+
+	// Names of the legs every trade is in, in leg order
+	std::array<std::string, LEG_COUNT> getLegNames() const;
+
+	// Methods writing the trades-file header line for the given leg names and the line of one trade. Legs are
+	// written in leg order, entry prices then exit prices, so a pairs back-test gives stock 1 before stock 2
+	static void writeTradeHeader(TextBuffer& out, const std::array<std::string, LEG_COUNT>& legNames);
+	static void writeTradeRow(TextBuffer& out, const TradeRow& row);
+
     // Log results
     virtual void logResults(const std::string& filename) const;
 
@@ -30,17 +80,19 @@ protected:
     double initialBalance;
     double currentBalance;
 
-	struct Trade {
-		std::string entryDate;
-		std::string exitDate;
-		std::unordered_map<std::string, double> entryPrices; // Map of stock symbol -> entry price
-		std::unordered_map<std::string, double> exitPrices;  // Map of stock symbol -> exit price
-		double profitLoss;
-	};
-    std::vector<Trade> trades;
+	// Sessions and symbols trades refer to, set by the derived class; many back-tests can share one of each
+	std::shared_ptr<const TradingCalendar> calendar;
+	std::shared_ptr<const SymbolTable> symbols;
+	std::array<SymbolTable::SymbolId, LEG_COUNT> legs{};   // Symbols of the legs every trade is in, set by the derived class
+	std::vector<Trade> trades;    // Append-only; reserve before a run so recording does not reallocate
+	PerformanceMetrics metrics;   // Updated by recordTrade for trades; engines add one bar per session
 
-    // Helper function to record a trade
+    // Helper function to record a trade; credits its profit/loss to currentBalance on top of the engine's own credit
     void recordTrade(const Trade& trade);
+
+	// Helper functions writing the trades-file header line of the legs and one line per trade
+	void writeTradeHeader(TextBuffer& out) const;
+	void writeTradeRows(TextBuffer& out) const;
 };
 
 #endif // BACKTESTING_HPP
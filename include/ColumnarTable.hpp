@@ -0,0 +1,200 @@
+#ifndef COLUMNARTABLE_HPP
+#define COLUMNARTABLE_HPP
+
+#include "Common.hpp"
+#include "Config.hpp"
+#include "Date.hpp"
+#include "MappedFile.hpp"
+#include "SymbolTable.hpp"
+#include <cstdint>
+
+// Binary columnar table for result sets, written row by row and read back through a memory map.
+//
+// Layout (host byte order):
+//   Header                  64 bytes, see below
+//   Blocks                  Up to blockRows rows each: one fixed-width chunk per column, each padded to
+//                           BLOCK_ALIGNMENT, then the block footer (row count, and offset, min, max and NaN count of
+//                           every chunk)
+//   Schema                  Per column: uint32 type, uint32 name length, name bytes
+//   Dictionary              uint64 count, then per string: uint32 length, bytes; String cells hold indices into it
+//   Block index             blockCount x uint64 footer offsets
+//
+// Min and max are taken over the values of a chunk as doubles (day numbers for dates, dictionary indices for
+// strings, NaN skipped), so a reader can skip blocks no row of which passes its filters; the NaN count keeps a block
+// whose other values all equal a NotEqual bound from being skipped.
+class ColumnarTable {
+public:
+    static constexpr char MAGIC[8] = {'S', 'A', 'R', 'E', 'S', 'C', 'O', 'L'};
+    static constexpr std::uint32_t FORMAT_VERSION = 2;
+    static constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+    static constexpr std::size_t BLOCK_ALIGNMENT = 64;
+
+    enum class ColumnType : std::uint32_t {
+        Float64,   // double
+        Int64,     // std::int64_t
+        Date,      // int32 day number, see Date
+        String     // uint32 index into the dictionary
+    };
+
+    struct Column {
+        std::string name;
+        ColumnType type;
+    };
+
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byteOrderMark;
+        std::uint32_t columnCount;
+        std::uint32_t blockRows;
+        std::uint64_t rowCount;
+        std::uint64_t blockCount;
+        std::uint64_t schemaOffset;
+        std::uint64_t dictionaryOffset;
+        std::uint64_t blockIndexOffset;
+    };
+    static_assert(sizeof(Header) == 64, "Columnar header must stay 64 bytes");
+
+    // Location and value range of one column chunk, as stored in a block footer
+    struct ChunkSummary {
+        std::uint64_t offset;
+        double min;
+        double max;
+        std::uint64_t nanCount;
+    };
+
+    // Width in bytes of one value of a column type
+    static std::size_t valueWidth(ColumnType type);
+
+    // Writes a table row by row: one add call per column, in schema order, then endRow.
+    // The file is complete only once close has run (the destructor calls it)
+    class Writer {
+    public:
+        // Throws std::runtime_error if the file cannot be created
+        Writer(const std::string& filename, std::vector<Column> columns,
+               std::size_t blockRows = Config::COLUMNAR_BLOCK_ROWS);
+        ~Writer();
+
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        // Methods to add the value of the next column of the row; throw std::invalid_argument if that column has
+        // another type or the row is already full
+        void addDouble(double value);
+        void addInteger(std::int64_t value);
+        void addDate(Date value);
+        void addString(const std::string& value);
+
+        // Method to finish the row; throws std::invalid_argument if a column was left out
+        void endRow();
+
+        // Method to write the last block, the schema, the dictionary and the index; returns false on a write error
+        bool close();
+
+        const std::vector<Column>& getColumns() const;
+        std::uint64_t rowCount() const;
+
+    private:
+        std::ofstream file;
+        std::vector<Column> columns;
+        std::size_t blockRows;
+        bool closed = false;
+
+        std::vector<std::vector<char>> chunks;   // Values of the current block, one buffer per column
+        std::vector<double> minimums, maximums;  // Of the current block
+        std::vector<std::uint64_t> nanCounts;    // Of the current block
+        std::size_t blockRowCount = 0;
+        std::size_t nextColumn = 0;
+        std::uint64_t totalRows = 0;
+        std::uint64_t offset = 0;
+        std::vector<std::uint64_t> footerOffsets;
+        SymbolTable dictionary;
+
+        // Helper functions to store the next value of the row and to write the current block out
+        void add(ColumnType type, const void* value, double rangeValue);
+        void writeBlock();
+        void write(const void* data, std::size_t size);
+        void padTo(std::uint64_t target);
+    };
+
+    // Reads a table through a memory map, returning only the requested columns of the rows passing every filter
+    class Reader {
+    public:
+        enum class Comparison { Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual };
+
+        // Condition on one column: numeric and date columns compare against value (dates as day numbers), string
+        // columns support Equal and NotEqual against text
+        struct Filter {
+            std::string column;
+            Comparison comparison;
+            double value = 0.0;
+            std::string text;
+
+            Filter(std::string column, Comparison comparison, double value);
+            Filter(std::string column, Comparison comparison, Date value);
+            Filter(std::string column, Comparison comparison, std::string text);
+        };
+
+        // One matching row, seen through the projection: index i is the i-th projected column
+        class RowView {
+        public:
+            std::size_t size() const;
+            double getDouble(std::size_t i) const;
+            std::int64_t getInteger(std::size_t i) const;
+            Date getDate(std::size_t i) const;
+            const std::string& getString(std::size_t i) const;
+
+            // Value of any numeric or date column as a double (a day number for dates)
+            double getValue(std::size_t i) const;
+
+        private:
+            friend class Reader;
+            const Reader* reader = nullptr;
+            const std::vector<std::size_t>* columns = nullptr;   // Projected column indices
+            const std::vector<const char*>* chunks = nullptr;    // Chunk of every column in the current block
+            std::size_t row = 0;
+
+            const char* cell(std::size_t i, ColumnType type) const;
+        };
+
+        using RowCallback = std::function<void(const RowView& row)>;
+
+        // Outcome of one scan
+        struct ScanStatistics {
+            std::size_t blocksRead = 0;
+            std::size_t blocksSkipped = 0;   // Ruled out by their footers
+            std::uint64_t rowsMatched = 0;
+        };
+
+        // Throws std::runtime_error if the file is missing, of another format or truncated
+        explicit Reader(const std::string& filename);
+
+        const std::vector<Column>& getColumns() const;
+        std::uint64_t rowCount() const;
+        std::size_t blockCount() const;
+
+        // Method to get the index of a column by name; throws std::invalid_argument if there is none
+        std::size_t columnIndex(const std::string& name) const;
+
+        // Method to call callback, in file order, for every row passing all filters. An empty projection selects every
+        // column; throws std::invalid_argument for unknown columns or unsupported string comparisons
+        ScanStatistics scan(const std::vector<std::string>& projection, const std::vector<Filter>& filters,
+                            const RowCallback& callback) const;
+
+    private:
+        MappedFile file;
+        Header header;
+        std::vector<Column> columns;
+        std::vector<std::string> dictionary;
+        std::vector<std::uint64_t> footerOffsets;
+
+        // Helper functions reading the sections after the header; throw std::runtime_error past the end of the file
+        void readSchema();
+        void readDictionary();
+        void readBlockIndex();
+        void checkRange(std::uint64_t offset, std::uint64_t size) const;
+        void checkArray(std::uint64_t offset, std::uint64_t count, std::uint64_t width) const;
+    };
+};
+
+#endif // COLUMNARTABLE_HPP
@@ -2,6 +2,7 @@
 #define CONFIG_HPP
 
 #include <string>
+#include <cstddef>
 
 class Config {
 public:
@@ -9,6 +10,17 @@ public:
     static const std::string NYSE_LISTINGS_FILE;
     static const std::string STOCK_DATA_DIR;
 	static const std::string OUTPUT_DIR;
+	static const std::string CACHE_FILE_EXTENSION;
+	static const bool USE_BINARY_CACHE;
+	static const unsigned int THREAD_COUNT; // 0 uses the hardware concurrency
+	static const std::size_t STORE_MEMORY_BUDGET_BYTES; // 0 keeps every loaded file resident
+	static const std::size_t GRAM_MATRIX_MAX_SYMBOLS; // Largest universe scored with a full spread-variance matrix
+	static const bool REPORT_STAGE_TIMINGS; // Print the wall time and thread utilisation of the selection stages
+	static const std::size_t WALK_FORWARD_RECOMPUTE_INTERVAL; // Window slides between exact rebuilds of the walk-forward sums
+	static const std::size_t RESULT_SINK_BUFFER_SIZE; // Bytes a result-sink channel buffers before writing them out
+	static const bool WRITE_COLUMNAR_RESULTS; // Also write results and trades as columnar tables, see ColumnarTable
+	static const std::string COLUMNAR_RESULT_EXTENSION;
+	static const std::size_t COLUMNAR_BLOCK_ROWS; // Rows per block of a columnar table
 
     static std::string getListingsFilePath() {
         return DATA_DIR + NYSE_LISTINGS_FILE;
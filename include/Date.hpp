@@ -0,0 +1,54 @@
+#ifndef DATE_HPP
+#define DATE_HPP
+
+#include <cstdint>
+#include <string>
+
+// Calendar date stored as a 32-bit day number (days since 1970-01-01, proleptic Gregorian).
+// Comparison and day stepping are integer operations; strings are only produced at I/O boundaries.
+class Date {
+public:
+    constexpr Date() : days(0) {}
+
+    static constexpr Date fromDayNumber(std::int32_t dayNumber) { return Date(dayNumber); }
+    constexpr std::int32_t dayNumber() const { return days; }
+
+    // Conversions to and from year, month (1-12) and day (1-31)
+    static Date fromCivil(int year, unsigned month, unsigned day);
+    void toCivil(int& year, unsigned& month, unsigned& day) const;
+
+    // Method to parse a YYYY-MM-DD date in place; returns false if the text is not a valid date
+    static bool parse(const char* first, const char* last, Date& date);
+    static bool parse(const std::string& text, Date& date);
+
+    // Method to parse a YYYY-MM-DD date; throws std::invalid_argument if the text is not a valid date
+    static Date parse(const std::string& text);
+
+    // Method to write the date as YYYY-MM-DD into out (10 characters, no terminator); returns the end pointer
+    char* format(char* out) const;
+    std::string toString() const;
+
+    // Day of the week, 0 = Sunday .. 6 = Saturday
+    int weekday() const;
+    bool isWeekend() const;
+
+    constexpr Date operator+(std::int32_t offset) const { return Date(days + offset); }
+    constexpr Date operator-(std::int32_t offset) const { return Date(days - offset); }
+    constexpr std::int32_t operator-(Date other) const { return days - other.days; }
+    Date& operator++() { ++days; return *this; }
+    Date& operator--() { --days; return *this; }
+
+    constexpr bool operator==(Date other) const { return days == other.days; }
+    constexpr bool operator!=(Date other) const { return days != other.days; }
+    constexpr bool operator<(Date other) const { return days < other.days; }
+    constexpr bool operator<=(Date other) const { return days <= other.days; }
+    constexpr bool operator>(Date other) const { return days > other.days; }
+    constexpr bool operator>=(Date other) const { return days >= other.days; }
+
+private:
+    explicit constexpr Date(std::int32_t dayNumber) : days(dayNumber) {}
+
+    std::int32_t days;
+};
+
+#endif // DATE_HPP
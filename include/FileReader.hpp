@@ -6,8 +6,34 @@
 
 class FileReader {
 public:
+	// Warnings collected while loading a stock data file
+	struct LoadReport {
+		std::size_t linesRead = 0;
+		std::size_t rowsLoaded = 0;
+		std::size_t malformedLines = 0;
+		std::size_t invalidFormatLines = 0;
+		std::size_t outOfRangeLines = 0;
+		bool fileOpened = false;
+		bool loadedFromCache = false;            // Rows came from the binary cache rather than the text file
+		std::vector<std::string> sampleWarnings; // First MAX_WARNING_SAMPLES warning messages
+
+		std::size_t warningCount() const { return malformedLines + invalidFormatLines + outOfRangeLines; }
+	};
+
+	// Cap on the number of warning messages kept in a LoadReport
+	static constexpr std::size_t MAX_WARNING_SAMPLES = 5;
+
     // Static method to load data from a file into a Stock object
     static bool loadStockDataFromFile(const std::string& filename, Stock& stock);
+
+    // Overload that collects warnings into a report instead of printing them
+    static bool loadStockDataFromFile(const std::string& filename, Stock& stock, LoadReport& report);
+
+    // Static method to build binary caches for every listing that lacks an up-to-date one; returns the number written
+    static std::size_t warmCache(const std::string& listingsFile, const std::string& stockDataDir, const std::string& fileExtension);
+
+    // Static method to print the warning summary of a load
+    static void printLoadReport(const std::string& filename, const LoadReport& report, std::ostream& os = std::cerr);
 	
 	// Static method to load NYSE stock listing from a file
     static std::vector<std::string> readNYSEListings(const std::string& filename);
@@ -18,6 +44,12 @@ public:
 private:
 	// Private if only used internally
 	static std::string trimInternal(const std::string& str);
+
+	// Parse a text stock data file into a Stock holding exactly the file contents
+	static bool parseTextFile(const std::string& filename, Stock& parsed, LoadReport& report);
+
+	// Merge loaded rows into a possibly non-empty Stock
+	static void mergeInto(Stock& stock, Stock&& loaded);
 };
 
-#endif // FILEREADER_H
\ No newline at end of file
+#endif // FILEREADER_H
@@ -0,0 +1,29 @@
+#ifndef GREEDYPAIRING_HPP
+#define GREEDYPAIRING_HPP
+
+#include "Common.hpp"
+
+// Greedy minimum-score pairing of items in listing order: the first unpaired item takes the unpaired item with the
+// lowest exact score (the earliest one on ties), then both leave the pool.
+// Unpaired items sit in a linked list, so taking a pair out is O(1). For each base, candidates are visited from a
+// min-heap of cheap lower bounds of their scores; exact scores are computed only until no bound can beat the best one.
+class GreedyPairing {
+public:
+    struct Pair {
+        std::size_t base;
+        std::size_t partner;
+        double score;   // Exact score of the pair
+    };
+
+    // Fills lowerBounds[k] with a value the exact score of (base, candidates[k]) cannot be below
+    using BoundFunction = std::function<void(std::size_t base, const std::vector<std::size_t>& candidates,
+                                             std::vector<double>& lowerBounds)>;
+
+    // Exact score of (base, candidate); lower is better
+    using ScoreFunction = std::function<double(std::size_t base, std::size_t candidate)>;
+
+    // Method to pair items 0 .. count-1; with an odd count the last unpaired item is left out
+    static std::vector<Pair> run(std::size_t count, const BoundFunction& lowerBounds, const ScoreFunction& exactScore);
+};
+
+#endif // GREEDYPAIRING_HPP
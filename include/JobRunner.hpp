@@ -0,0 +1,44 @@
+#ifndef JOBRUNNER_HPP
+#define JOBRUNNER_HPP
+
+#include "PairsBackTestDriver.hpp"
+#include "WalkForwardSelector.hpp"
+
+// Batch mode running pair selection and back-testing over many (formation, trading) windows in one process.
+// Stocks are loaded once through the shared StockDataStore and keep their prefix sums between windows;
+// windows sharing a formation period share one selection.
+class JobRunner {
+public:
+	using Window = PairsBackTestDriver::Window;
+
+	// Settings common to every window; the defaults are those of the single-window run in main
+	struct Settings {
+		std::string stockDataDir = Config::getStockDataDir();
+		std::string fileExtension = ".txt";
+		std::string priceType = "adj close";
+		double priceVolumeThreshold = 500000;
+		double initialBalance = 1000;
+		double entryMultiplier = 2.0;   // Entry threshold in formation standard deviations
+		double exitMultiplier = 1.5;    // Exit threshold in formation standard deviations
+		double tradeAmount = 100.0;
+		double slippage = 0;
+	};
+
+	// Method to read a job file: one window per line as formationStart,formationEnd,tradingStart,tradingEnd.
+	// Blank lines and lines starting with '#' are skipped; throws std::runtime_error naming the first bad line
+	static std::vector<Window> readJobFile(const std::string& filename);
+
+	// Method to run every window and write one consolidated results file, each row prefixed with its window,
+	// and one trades file. Failed windows and pairs are reported on std::cerr; returns the number of rows written
+	static std::size_t run(const std::vector<Window>& windows, const std::vector<std::string>& stockListings,
+		const Settings& settings, const std::string& resultsFile, const std::string& tradesFile);
+
+	// Method to pair the liquid listings over a formation window of windowLength sessions walking forward across
+	// startDate to endDate, re-pairing every rebalanceInterval sessions, and write one row per rebalance and pair.
+	// Throws std::invalid_argument on bad dates, price type or window sizes; returns the number of rows written
+	static std::size_t runWalkForward(const std::vector<std::string>& stockListings, const Settings& settings,
+		const std::string& startDate, const std::string& endDate, std::size_t windowLength, std::size_t rebalanceInterval,
+		const std::string& pairingsFile);
+};
+
+#endif // JOBRUNNER_HPP
@@ -0,0 +1,37 @@
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include "Common.hpp"
+
+// Read-only view of a whole file, memory-mapped where the platform supports it
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+
+    // Non-copyable, movable
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Method to map a file, releasing any previous mapping; returns false if it cannot be opened
+    bool open(const std::string& filename);
+
+    // Method to release the mapping
+    void close();
+
+    bool isOpen() const;
+    const char* data() const;
+    std::size_t size() const;
+
+private:
+    const char* mappedData = nullptr;
+    std::size_t mappedSize = 0;
+    bool opened = false;
+    bool mapped = false;                // True when mappedData points at an mmap region
+    std::vector<char> fallbackBuffer;   // Holds the contents where mmap is unavailable
+};
+
+#endif // MAPPEDFILE_HPP
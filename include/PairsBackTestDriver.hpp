@@ -0,0 +1,145 @@
+#ifndef PAIRSBACKTESTDRIVER_HPP
+#define PAIRSBACKTESTDRIVER_HPP
+
+#include "PairsTradingBackTesting.hpp"
+#include "ResultSink.hpp"
+#include "ColumnarTable.hpp"
+
+// Back-tests every selected pair concurrently and writes the results once, in pair order.
+// Each pair runs on the thread pool against the shared in-memory stock data and fills only its own slot of a
+// preallocated outcome array; writing afterwards walks that array, so files and messages come out the same for any
+// thread count.
+class PairsBackTestDriver {
+public:
+	// Formation period the pairs were selected on and trading period they are back-tested over
+	struct Window {
+		std::string formationStart;
+		std::string formationEnd;
+		std::string tradingStart;
+		std::string tradingEnd;
+	};
+
+	struct Settings {
+		std::string stockDataDir = Config::getStockDataDir();
+		std::string fileExtension = ".txt";
+		std::string priceType = "adj close";
+		double initialBalance = 1000;
+		unsigned int threadCount = Config::THREAD_COUNT; // 0 uses the hardware concurrency
+	};
+
+	// Back-test settings of one pair, given its formation statistics
+	using ConfigPolicy = std::function<PairsTradingBackTesting::BackTestingConfig(
+		const std::string& pair, const PairsTradingBackTesting::PairStatistics& stats)>;
+
+	// Policy setting the entry and exit thresholds to multiples of the formation spread standard deviation
+	static ConfigPolicy thresholdPolicy(double entryMultiplier, double exitMultiplier, double tradeAmount, double slippage = 0.0);
+
+	// Summary metrics of one back-test
+	using PairSummary = PairsTradingBackTesting::BackTestSummary;
+
+	struct PairOutcome {
+		std::string pair;
+		PairsTradingBackTesting::PairStatistics stats;
+		bool succeeded = false;
+		std::string error;                                        // Set when the back-test failed
+		std::string messages;                                     // Progress messages of the back-test
+		PairSummary summary;
+		std::array<std::string, BackTesting::LEG_COUNT> legNames; // Stock 1 first
+		std::vector<BackTesting::TradeRow> trades;                // Copied out of the back-test, which is not kept
+	};
+
+	// Back-test settings of one pair for a sweep, one per grid point; every pair should get the same number in the same order
+	using GridPolicy = std::function<std::vector<PairsTradingBackTesting::BackTestingConfig>(
+		const std::string& pair, const PairsTradingBackTesting::PairStatistics& stats)>;
+
+	// Grid of thresholdPolicy settings, every entry multiplier with every exit multiplier, entry-major
+	static GridPolicy thresholdGrid(const std::vector<double>& entryMultipliers, const std::vector<double>& exitMultipliers,
+		double tradeAmount, double slippage = 0.0);
+
+	struct PairSweep {
+		std::string pair;
+		bool succeeded = false;
+		std::string error;                                            // Set when the sweep failed
+		std::vector<PairsTradingBackTesting::BackTestingConfig> configs;
+		std::vector<PairSummary> summaries;                           // Aligned with configs
+	};
+
+	// Header of the results file matching writeResultRow
+	static const std::string RESULT_HEADER;
+
+	// Schemas of the columnar results and trades tables matching addResultRow and addTradeRows; both start with the
+	// four window dates
+	static const std::vector<ColumnarTable::Column> RESULT_COLUMNS;
+	static const std::vector<ColumnarTable::Column> TRADE_COLUMNS;
+
+	// Columnar tables to add rows to alongside the text files, and the window tagging the rows; either table may be null
+	struct ColumnarOutput {
+		Window window;
+		ColumnarTable::Writer* results = nullptr;
+		ColumnarTable::Writer* trades = nullptr;
+	};
+
+	// Calendar and symbol table shared by the back-tests of one window: every trading-period date of any leg, and every
+	// leg interned in pair order
+	struct SharedTables {
+		std::shared_ptr<const TradingCalendar> calendar;
+		std::shared_ptr<const SymbolTable> symbols;
+	};
+
+	// Method to build the shared tables of the pairs over the trading period of a window; legs that cannot be loaded
+	// are left out, their back-tests failing anyway. Throws std::invalid_argument for an invalid trading date
+	static SharedTables buildSharedTables(const std::map<std::string, PairsTradingBackTesting::PairStatistics>& pairs,
+		const Window& window, const Settings& settings);
+
+	// Method to set up the back-test of one selected pair over the trading period of a window, ready to run
+	static PairsTradingBackTesting prepareBackTest(const std::string& pair, const Window& window, const Settings& settings,
+		const SharedTables& tables);
+
+	// Method to back-test every pair concurrently; outcomes are in the pair order of the map
+	static std::vector<PairOutcome> run(const std::map<std::string, PairsTradingBackTesting::PairStatistics>& pairs,
+		const Window& window, const Settings& settings, const ConfigPolicy& policy);
+
+	// Method to sweep every pair over its grid concurrently, each pair's spread computed once; sweeps are in the pair
+	// order of the map
+	static std::vector<PairSweep> sweep(const std::map<std::string, PairsTradingBackTesting::PairStatistics>& pairs,
+		const Window& window, const Settings& settings, const GridPolicy& grid);
+
+	// Method to write the statistics and summary metrics of one pair as a row of the results file
+	static void writeResultRow(TextBuffer& out, const PairOutcome& outcome);
+
+	// Method to write the block of one pair's trades to the trades file, as PairsTradingBackTesting::writeTrades does
+	static void writeTrades(TextBuffer& out, const PairOutcome& outcome);
+
+	// Methods to add the statistics and summary metrics of one pair, and one row per trade, to columnar tables.
+	// As in the trades file, legs are in pair order: stock 1 first
+	static void addResultRow(ColumnarTable::Writer& out, const Window& window, const PairOutcome& outcome);
+	static void addTradeRows(ColumnarTable::Writer& out, const Window& window, const PairOutcome& outcome);
+
+	// Method to write the outcomes in order: a result row (after rowPrefix) and the trades of every back-tested pair, and
+	// progress messages and failures straight to std::cout and std::cerr as each pair is written. tradesHeaderWritten tells whether the trades stream
+	// already has its header and is updated; the first back-tested pair writes it, with or without trades. Rows are
+	// also added to the columnar tables, if given, in the same order.
+	// Returns the number of result rows written
+	static std::size_t write(const std::vector<PairOutcome>& outcomes, std::ostream& results, std::ostream& trades,
+		bool& tradesHeaderWritten, const std::string& rowPrefix = "", const ColumnarOutput* columnar = nullptr);
+
+	// Method combining run and write without holding every outcome: each pair is formatted on the worker that ran it
+	// and handed to a ResultSink, which writes it on a background thread once the pairs before it are written.
+	// The output is the same as that of run followed by write
+	static std::size_t runAndWrite(const std::map<std::string, PairsTradingBackTesting::PairStatistics>& pairs,
+		const Window& window, const Settings& settings, const ConfigPolicy& policy, std::ostream& results,
+		std::ostream& trades, bool& tradesHeaderWritten, const std::string& rowPrefix = "",
+		const ColumnarOutput* columnar = nullptr);
+
+private:
+	// Helper function to back-test the pair of an outcome holding its pair and statistics
+	static void runPair(PairOutcome& outcome, const Window& window, const Settings& settings, const ConfigPolicy& policy,
+		const SharedTables& tables);
+
+	// Helper function to format an outcome as a result-sink record of its result row and trades. Messages and errors
+	// are printed, and columnar rows added, when the record is finalized, on the writer thread and in pair order
+	static ResultSink::Record formatOutcome(const PairOutcome& outcome, std::uint64_t sequence,
+		const std::string& rowPrefix, bool& tradesHeaderWritten, const ColumnarOutput* columnar);
+};
+
+#endif // PAIRSBACKTESTDRIVER_HPP
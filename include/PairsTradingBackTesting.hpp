@@ -8,6 +8,14 @@
 #include "StandardNormalDistribution.hpp"
 #include "StatisticalAnalysis.hpp"
 #include "Config.hpp"
+#include "ThreadPool.hpp"
+#include "StockDataStore.hpp"
+#include "TradingCalendar.hpp"
+#include "PricePanel.hpp"
+#include "SpreadKernels.hpp"
+#include "SpreadVarianceMatrix.hpp"
+#include "GreedyPairing.hpp"
+#include "StageReport.hpp"
 
 class PairsTradingBackTesting : public BackTesting {
 public:
@@ -25,13 +33,60 @@ public:
 		double kpssPValueLong;
 	};
 	
+	// Engine running the back-test; both produce the same trades and balances
+	enum class BackTestEngine {
+		Vectorised, // Both legs aligned into arrays once, spreads in one pass, entry/exit decided by index
+		Legacy      // Date-keyed lookups for every session
+	};
+
     struct BackTestingConfig {
         double entryThreshold = 0.4;
         double exitThreshold = 0.2;
         double tradeAmount = 1000.0;
         double slippage = 0.0;
+        BackTestEngine engine = BackTestEngine::Vectorised;
+        bool keepEquityCurve = false;   // Keep the marked-to-market equity of every session in the metrics
     };
 
+	// Summary metrics of one back-test
+	struct BackTestSummary {
+		double rateReturn = 0.0;   // In %
+		int tradeCount = 0;
+		double maxDrawdown = 0.0;
+		double sharpeRatio = 0.0;
+	};
+
+	// How candidate spreads are scored before near-ties are settled with the exact statistics
+	enum class SpreadScoring {
+		Auto,       // GramMatrix up to Config::GRAM_MATRIX_MAX_SYMBOLS symbols, Pairwise beyond
+		Pairwise,   // One batched SpreadKernels pass per base stock
+		GramMatrix  // One SpreadVarianceMatrix for the whole universe
+	};
+
+	// Settings of the pair-selection pipeline
+	struct SelectionConfig {
+		unsigned int threadCount = Config::THREAD_COUNT; // 0 uses the hardware concurrency
+		SpreadScoring scoring = SpreadScoring::Auto;
+		bool reportStageTimings = Config::REPORT_STAGE_TIMINGS;
+	};
+
+	// Outcome of the liquidity and calendar filters for one listing
+	enum class ListingFilterStatus { Accepted, LoadError, PriceVolumeError, Illiquid, CalendarMismatch };
+
+	struct ListingFilterResult {
+		std::string symbol;
+		ListingFilterStatus status = ListingFilterStatus::Accepted;
+		std::string reason;                    // Empty for accepted listings
+		FileReader::LoadReport loadReport;
+	};
+
+	// Output of the universe filtering stage, in listing order
+	struct UniverseFilterResult {
+		std::vector<std::string> survivors;
+		std::vector<std::shared_ptr<const Stock>> survivorStocks;              // Aligned with survivors
+		std::vector<ListingFilterResult> listingResults;                        // One per input listing
+	};
+
 	// For the output of selectPairsForBackTesting(benchmark)
 	struct LNpairStatistic{
 		std::string pair;
@@ -53,10 +108,29 @@ public:
                             const std::unordered_map<std::string, double>& pairSelectionData2,
                             double initialBalance);
 
+    // Constructor recording trades against a calendar and symbol table shared with other back-tests. The calendar must
+    // hold every date of stock1Data and the table both names; throws std::out_of_range otherwise. Null tables are
+    // replaced by ones of this pair alone, as with the constructor above
+    PairsTradingBackTesting(const std::string& stock1Name,
+                            const std::unordered_map<std::string, double>& stock1Data,
+                            const std::string& stock2Name,
+                            const std::unordered_map<std::string, double>& stock2Data,
+                            const std::unordered_map<std::string, double>& pairSelectionData1,
+                            const std::unordered_map<std::string, double>& pairSelectionData2,
+                            double initialBalance,
+                            std::shared_ptr<const TradingCalendar> sharedCalendar,
+                            std::shared_ptr<const SymbolTable> sharedSymbols);
+
     // Run the back-test
 	void run() override;
 	void run(const BackTestingConfig& config);
 
+	// Method to evaluate many configurations over the same aligned spread in a single pass, the state of every
+	// configuration held one array per field. Each summary equals what run(config) on a fresh back-test would give;
+	// nothing is recorded or printed. Slippage and engine are ignored, as they are by run(config). Like run(config), throws
+	// std::out_of_range if a trade is left open and stock2 has no price on the last date of stock1
+	std::vector<BackTestSummary> sweep(const std::vector<BackTestingConfig>& configs) const;
+
 	static std::map<std::string, PairStatistics> selectPairsForBackTesting(
 		std::vector<std::string> stockListings,
 		const std::string& stockDataDir,
@@ -66,6 +140,32 @@ public:
 		const std::string& endDate,
 		double priceVolumeThreshold);
 
+	static std::map<std::string, PairStatistics> selectPairsForBackTesting(
+		std::vector<std::string> stockListings,
+		const std::string& stockDataDir,
+		const std::string& fileExtension,
+		const std::string& priceType,
+		const std::string& startDate,
+		const std::string& endDate,
+		double priceVolumeThreshold,
+		const SelectionConfig& selectionConfig);
+
+	// Load every listing and keep those that are liquid and trade on every session of the calendar
+	static UniverseFilterResult filterUniverse(
+		const std::vector<std::string>& stockListings,
+		const std::string& stockDataDir,
+		const std::string& fileExtension,
+		const std::string& priceType,
+		const std::string& startDate,
+		const std::string& endDate,
+		double priceVolumeThreshold,
+		const TradingCalendar& calendar,
+		ThreadPool& threadPool);
+
+	// Print the per-listing outcome of filterUniverse
+	static void printFilterSummary(const UniverseFilterResult& result, const std::string& startDate,
+		const std::string& endDate, std::ostream& os = std::cout);
+
 	static std::unordered_map<std::string, PairsTradingBackTesting::LNpairStatistic> selectPairsForBackTesting(
 		const std::vector<std::string>& stockListings,
 		const std::string& stockDataDir,
@@ -76,9 +176,48 @@ public:
 		const std::string& endDate
 	);
 
+	// Overload running the per-listing regressions on a thread pool; results do not depend on the thread count
+	static std::unordered_map<std::string, PairsTradingBackTesting::LNpairStatistic> selectPairsForBackTesting(
+		const std::vector<std::string>& stockListings,
+		const std::string& stockDataDir,
+		const std::string& fileExtension,
+		const std::string& benchmarkSymbol,
+		const std::string& priceType,
+		const std::string& startDate,
+		const std::string& endDate,
+		const SelectionConfig& selectionConfig
+	);
+
+	// Receives the rows of the benchmark screen, in listing order, on the calling thread
+	using BenchmarkRowSink = std::function<void(const LNpairStatistic&)>;
+
+	// Streaming form of the benchmark screen: each listing is normalised, differenced, logged and regressed in one pass,
+	// and rows are handed to the sink block by block, so memory does not grow with the number of listings.
+	// Failed listings are reported on std::cerr; returns the number of rows delivered
+	static std::size_t screenAgainstBenchmark(
+		const std::vector<std::string>& stockListings,
+		const std::string& stockDataDir,
+		const std::string& fileExtension,
+		const std::string& benchmarkSymbol,
+		const std::string& priceType,
+		const std::string& startDate,
+		const std::string& endDate,
+		const BenchmarkRowSink& sink,
+		const SelectionConfig& selectionConfig
+	);
+
 	// Override the logResults functions
 	void logResults(const std::string& filename) const override; // Override logResults
 
+	// Trades-file pieces written by logResults: the header line and the block of this pair's trades
+	void writeTradesHeader(std::ostream& os) const;
+	void writeTrades(std::ostream& os) const;
+	void writeTradesHeader(TextBuffer& out) const;
+	void writeTrades(TextBuffer& out) const;
+
+	// Method to send the progress messages of run(), such as closing an open trade, somewhere other than std::cout
+	void setMessageStream(std::ostream& os);
+
 private:
     std::string stock1Name;
     std::string stock2Name;
@@ -88,12 +227,42 @@ private:
     std::unordered_map<std::string, double> normalizedStock2Data;
     std::unordered_map<std::string, double> pairSelectionData1;
     std::unordered_map<std::string, double> pairSelectionData2;
+
+    // Date-sorted raw prices of both legs and the first formation price each is normalized by
+    Series stock1Series;
+    Series stock2Series;
+    double stock1ReferenceBase;
+    double stock2ReferenceBase;
+    SymbolTable::SymbolId stock1Symbol;
+    SymbolTable::SymbolId stock2Symbol;
+    std::ostream* messageStream = &std::cout;
     
+	// Both legs on the sessions of stock1 that stock2 also has, with normalized prices and absolute spreads
+	struct AlignedLegs {
+		std::vector<std::uint32_t> sessions;   // Position of each aligned session in stock1Series
+		Eigen::ArrayXd prices1;
+		Eigen::ArrayXd prices2;
+		Eigen::ArrayXd normalized1;
+		Eigen::ArrayXd normalized2;
+		Eigen::ArrayXd absoluteSpreads;
+	};
+	AlignedLegs alignLegs() const;
+
+	// Helper function to map a position in stock1Series to its session index in the calendar
+	std::uint32_t calendarSession(std::size_t stock1Position) const;
+
+	// Back-test engines behind run(config)
+	void runVectorised(const BackTestingConfig& config);
+	void runLegacy(const BackTestingConfig& config);
+
 	// Helper functions
     double calculateSpread(const std::string& date) const;
 	double calculateProfitLoss(const std::string& entryDate,
 						   const std::string& exitDate,
 						   const double& tradeAmount) const;
+	static double calculateProfitLoss(double entryPrice1, double entryPrice2, double exitPrice1, double exitPrice2,
+							   double normalizedEntryPrice1, double normalizedEntryPrice2,
+							   const double& tradeAmount);
     bool isEntrySignal(double spread, double threshold) const;
     bool isExitSignal(double spread, double threshold) const;
 };
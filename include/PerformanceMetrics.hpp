@@ -0,0 +1,73 @@
+#ifndef PERFORMANCEMETRICS_HPP
+#define PERFORMANCEMETRICS_HPP
+
+#include "Common.hpp"
+
+// Streaming performance metrics of a back-test, updated in O(1) per closed trade and per session (bar).
+// Per trade: Welford mean and variance of trade returns (profit/loss over the initial balance) and the drawdown of the
+// realised balance. Per bar: the same statistics over the daily returns of the marked-to-market equity, plus the time
+// spent under the running peak. Every metric is available at any point without a second pass.
+class PerformanceMetrics {
+public:
+    // Returns and drawdowns are fractions of balances; with a zero initial balance or peak they count as 0
+    explicit PerformanceMetrics(double initialBalance = 0.0);
+
+    // Method to keep the equity of every bar, reserving room for sessionCount bars so adding them does not reallocate
+    void keepEquityCurve(std::size_t sessionCount);
+
+    // Method to add the profit/loss of a closed trade
+    void addTrade(double profitLoss);
+
+    // Method to add one session's equity: initial balance plus realised and open (marked-to-market) profit/loss.
+    // A session following one whose equity was not positive counts as a zero return
+    void addBar(double equity);
+
+    // Per-trade metrics; ratios are 0 when their deviation is 0
+    std::size_t tradeCount() const;
+    double tradeSharpeRatio() const;    // Mean over population standard deviation of trade returns
+    double tradeSortinoRatio() const;   // Mean over downside deviation (below 0) of trade returns
+    double maxDrawdown() const;         // Largest fall of the realised balance from its peak, as a fraction of the peak
+
+    // Per-bar metrics; ratios are per session, not annualised
+    std::size_t barCount() const;
+    double dailySharpeRatio() const;
+    double dailySortinoRatio() const;
+    double maxDailyDrawdown() const;            // Largest fall of the equity from its peak, as a fraction of the peak
+    std::size_t timeUnderWater() const;         // Sessions ending below the running peak
+    std::size_t longestTimeUnderWater() const;  // Longest run of such sessions
+    double getEquity() const;                   // Equity of the last bar, the initial balance before any
+    double getRealisedBalance() const;          // Initial balance plus the profit/loss of every closed trade
+    const std::vector<double>& getEquityCurve() const;  // Empty unless keepEquityCurve was called
+
+private:
+    // Welford mean and variance of a stream, with the sum of squared shortfalls below 0
+    struct RunningMoments {
+        std::size_t count = 0;
+        double mean = 0.0;
+        double sumSquaredDeviations = 0.0;
+        double sumSquaredShortfalls = 0.0;
+
+        void add(double value);
+        double sharpeRatio() const;
+        double sortinoRatio() const;
+    };
+
+    double initialBalance;
+
+    RunningMoments tradeReturns;
+    double realisedBalance;
+    double realisedPeak;
+    double realisedMaxDrawdown = 0.0;
+
+    RunningMoments dailyReturns;
+    double equity;
+    double equityPeak;
+    double equityMaxDrawdown = 0.0;
+    std::size_t underWater = 0;
+    std::size_t currentUnderWaterRun = 0;
+    std::size_t longestUnderWaterRun = 0;
+    bool keepCurve = false;
+    std::vector<double> equityCurve;
+};
+
+#endif // PERFORMANCEMETRICS_HPP
@@ -0,0 +1,61 @@
+#ifndef PREFIXSUMINDEX_HPP
+#define PREFIXSUMINDEX_HPP
+
+#include "Stock.hpp"
+#include <cstdint>
+
+// Prefix sums over a stock's columns and its price x volume series.
+// A date-range query costs two binary searches for the row bounds and O(1) arithmetic; missing (NaN) values
+// are skipped and not counted.
+class PrefixSumIndex {
+public:
+    // Fields that have a price x volume series: every field, volume included (volume squared, as the per-day product
+    // of the original calculation gave)
+    static constexpr std::size_t PRICE_FIELD_COUNT = Stock::FIELD_COUNT;
+
+    // Sum and number of valid values over a range
+    struct RangeSummary {
+        double sum = 0.0;
+        std::size_t count = 0;
+
+        // Throws std::runtime_error if the range holds no valid values
+        double average() const;
+    };
+
+    PrefixSumIndex() = default;
+    explicit PrefixSumIndex(const Stock& stock);
+
+    // Method to summarise a raw column over [startDate, endDate]
+    RangeSummary summarize(Stock::Field field, Date startDate, Date endDate) const;
+
+    // Method to summarise price x volume of a price field over [startDate, endDate]; only days with both values count
+    RangeSummary summarizePriceVolume(Stock::Field priceField, Date startDate, Date endDate) const;
+
+    // Row-based forms for callers that already hold row bounds [firstRow, lastRow)
+    RangeSummary summarizeRows(Stock::Field field, std::size_t firstRow, std::size_t lastRow) const;
+    RangeSummary summarizePriceVolumeRows(Stock::Field priceField, std::size_t firstRow, std::size_t lastRow) const;
+
+    double sum(Stock::Field field, Date startDate, Date endDate) const;
+    std::size_t count(Stock::Field field, Date startDate, Date endDate) const;
+    double average(Stock::Field field, Date startDate, Date endDate) const;
+    double averagePriceVolume(Stock::Field priceField, Date startDate, Date endDate) const;
+
+    std::size_t size() const;
+    std::size_t memoryUsage() const;
+
+private:
+    // Each prefix array has size() + 1 entries; entry i covers rows [0, i)
+    struct PrefixColumn {
+        std::vector<double> sums;
+        std::vector<std::uint32_t> counts;
+    };
+
+    std::vector<Date> dates;
+    std::array<PrefixColumn, Stock::FIELD_COUNT> fieldPrefixes;
+    std::array<PrefixColumn, PRICE_FIELD_COUNT> priceVolumePrefixes;
+
+    std::pair<std::size_t, std::size_t> rowRange(Date startDate, Date endDate) const;
+    static RangeSummary summarizePrefix(const PrefixColumn& prefix, std::size_t firstRow, std::size_t lastRow);
+};
+
+#endif // PREFIXSUMINDEX_HPP
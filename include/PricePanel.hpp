@@ -0,0 +1,49 @@
+#ifndef PRICEPANEL_HPP
+#define PRICEPANEL_HPP
+
+#include <Eigen/Dense>
+#include "Stock.hpp"
+#include "TradingCalendar.hpp"
+
+// Aligned sessions x symbols price matrix for a universe of stocks.
+// Prices are stored column-major in one contiguous Eigen::MatrixXd, so each symbol's series is a contiguous column.
+class PricePanel {
+public:
+    // Read-only view of one symbol's series
+    using ConstColumn = Eigen::Map<const Eigen::VectorXd>;
+
+    PricePanel() = default;
+
+    // Method to build the panel over the calendar sessions in [startDate, endDate] for a field of each stock.
+    // Every stock must have a value on every session (see TradingCalendar::isAligned); throws std::invalid_argument otherwise
+    static PricePanel build(const std::vector<std::string>& symbols,
+                            const std::vector<std::shared_ptr<const Stock>>& stocks,
+                            const TradingCalendar& calendar, Stock::Field field,
+                            Date startDate, Date endDate);
+
+    // Method to divide every column by its value on the first session, in place; throws if that value is zero
+    void normalizeToFirstSession();
+
+    std::size_t sessionCount() const;
+    std::size_t symbolCount() const;
+
+    const Eigen::MatrixXd& getPrices() const;
+    const std::vector<Date>& getSessions() const;
+    const std::vector<std::string>& getSymbols() const;
+    const std::string& getSymbol(std::size_t column) const;
+
+    // Method to find the column of a symbol; -1 if it is not in the panel
+    std::int64_t symbolIndex(const std::string& symbol) const;
+
+    // Views of one symbol's series
+    ConstColumn column(std::size_t index) const;
+    const double* columnData(std::size_t index) const;
+
+private:
+    Eigen::MatrixXd prices;                                    // sessions x symbols, column-major
+    std::vector<Date> sessions;
+    std::vector<std::string> symbols;
+    std::unordered_map<std::string, std::size_t> symbolIndices; // First column of each symbol
+};
+
+#endif // PRICEPANEL_HPP
@@ -0,0 +1,69 @@
+#ifndef RESULTSINK_HPP
+#define RESULTSINK_HPP
+
+#include "Common.hpp"
+#include "Config.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Ordered, asynchronous writer of formatted results to a fixed set of output streams (channels), for many producers.
+// Any number of producer threads submit records through a lock-free queue; a background thread puts them back into
+// sequence order, appends each record's text to one large buffer per channel and writes a buffer out once it is full.
+// The output is the same whatever the order records arrive in.
+class ResultSink {
+public:
+    struct Record {
+        std::uint64_t sequence = 0;          // Position in the output; every value from 0 up is submitted once
+        std::vector<std::string> chunks;     // Text per channel, chunks[i] going to channel i; may be shorter
+
+        // Optional step run on the writer thread, in sequence order, just before the chunks are written; it may edit
+        // them, e.g. to add a header only the first record in order should write. It must not throw
+        std::function<void(std::vector<std::string>& chunks)> finalize;
+    };
+
+    // The streams must outlive the sink. A channel's buffer is written out once it holds bufferSize bytes, so channels
+    // are meant for result files; diagnostics would only show once a buffer fills or the sink closes
+    explicit ResultSink(std::vector<std::ostream*> channels, std::size_t bufferSize = Config::RESULT_SINK_BUFFER_SIZE);
+    ~ResultSink();
+
+    ResultSink(const ResultSink&) = delete;
+    ResultSink& operator=(const ResultSink&) = delete;
+
+    // Method to hand over a record; thread-safe and lock-free
+    void submit(Record record);
+
+    // Method to write every submitted record and flush the channels, once every submit call has returned; records after
+    // a missing sequence number are written in order after the gap. Called by the destructor; the sink takes no
+    // records afterwards
+    void close();
+
+private:
+    // Node of the multi-producer, single-consumer queue: producers swap themselves in as the head, the writer thread
+    // follows the next links from a stub node
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        Record record;
+    };
+
+    std::vector<std::ostream*> channels;
+    std::vector<std::string> buffers;   // One per channel
+    std::size_t bufferSize;
+
+    std::atomic<Node*> head;
+    Node* tail;                         // Writer thread only
+
+    std::atomic<bool> closing{false};
+    std::mutex wakeMutex;               // Only for sleeping; submit never takes it
+    std::condition_variable wake;
+    std::thread writer;
+
+    // Helper functions of the writer thread
+    void writeLoop();
+    bool pop(Record& record);
+    void append(Record& record);
+    void flush(std::size_t channel);
+};
+
+#endif // RESULTSINK_HPP
@@ -0,0 +1,65 @@
+#ifndef SERIESVIEW_HPP
+#define SERIESVIEW_HPP
+
+#include "Common.hpp"
+#include "Date.hpp"
+
+// Non-owning view of a date-sorted series: a date axis and the values aligned with it.
+// A view stays valid only as long as the storage it points into (a Stock, a Series or a caller's arrays).
+class SeriesView {
+public:
+    SeriesView() = default;
+    SeriesView(const Date* dates, const double* values, std::size_t size)
+        : dateData(dates), valueData(values), count(size) {}
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    const Date* dates() const { return dateData; }
+    const double* values() const { return valueData; }
+
+    Date dateAt(std::size_t i) const { return dateData[i]; }
+    double valueAt(std::size_t i) const { return valueData[i]; }
+
+    // Method to view the entries [first, last) of this series
+    SeriesView subView(std::size_t first, std::size_t last) const {
+        return SeriesView(dateData + first, valueData + first, last - first);
+    }
+
+private:
+    const Date* dateData = nullptr;
+    const double* valueData = nullptr;
+    std::size_t count = 0;
+};
+
+// Owning, reusable buffer that the SeriesView functions write their results into.
+// Keeping one Series alive across calls reuses its capacity instead of allocating a new map every time.
+class Series {
+public:
+    Series() = default;
+
+    std::size_t size() const { return dates.size(); }
+    bool empty() const { return dates.empty(); }
+
+    void reserve(std::size_t n);
+    void resize(std::size_t n);
+    void clear();
+    void push_back(Date date, double value);
+
+    // Method to copy a series into this buffer; the view may point into this buffer itself
+    void assign(SeriesView source);
+
+    std::vector<Date>& getDates() { return dates; }
+    std::vector<double>& getValues() { return values; }
+    const std::vector<Date>& getDates() const { return dates; }
+    const std::vector<double>& getValues() const { return values; }
+
+    SeriesView view() const { return SeriesView(dates.data(), values.data(), dates.size()); }
+    operator SeriesView() const { return view(); }
+
+private:
+    std::vector<Date> dates;
+    std::vector<double> values;
+};
+
+#endif // SERIESVIEW_HPP
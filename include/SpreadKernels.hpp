@@ -0,0 +1,33 @@
+#ifndef SPREADKERNELS_HPP
+#define SPREADKERNELS_HPP
+
+#include <cstddef>
+
+// Fused kernels for the statistics of the spread a - b between two aligned series.
+// Each call makes one pass over the data and allocates nothing; an AVX2 path is chosen at runtime when the CPU
+// supports it, with a portable scalar fallback.
+class SpreadKernels {
+public:
+    // Mean and population standard deviation of a spread, and a value that neither the exact standard deviation nor a
+    // two-pass double-precision computation of it (StockAnalysis::calculateStatistics) can be below, whatever the
+    // rounding of either
+    struct SpreadStatistics {
+        double mean = 0.0;
+        double standardDeviation = 0.0;
+        double standardDeviationLowerBound = 0.0;
+    };
+
+    // Method to compute the statistics of a[i] - b[i] for i in [0, n)
+    static SpreadStatistics spreadStatistics(const double* a, const double* b, std::size_t n);
+
+    // Batched form: score one base series against several columns of a column-major matrix.
+    // Column columns[k] starts at matrix + columns[k] * leadingDimension; out[k] receives its statistics
+    static void spreadStatistics(const double* base, const double* matrix, std::size_t rows,
+                                 std::size_t leadingDimension, const std::size_t* columns,
+                                 std::size_t columnCount, SpreadStatistics* out);
+
+    // True when the AVX2 path is in use on this machine
+    static bool usesAvx2();
+};
+
+#endif // SPREADKERNELS_HPP
@@ -0,0 +1,37 @@
+#ifndef SPREADVARIANCEMATRIX_HPP
+#define SPREADVARIANCEMATRIX_HPP
+
+#include <Eigen/Dense>
+#include "PricePanel.hpp"
+
+// Population variance of the spread a - b for every pair of panel columns, from one covariance matrix:
+// Var(a - b) = Var(a) + Var(b) - 2 Cov(a, b).
+// The covariance comes from a single symmetric rank update (one blocked GEMM) over the centred panel, so the whole
+// matrix costs about sessions x symbols^2 flops and symbols^2 doubles of memory, plus a centred copy of the panel
+// while the covariance is built.
+class SpreadVarianceMatrix {
+public:
+    SpreadVarianceMatrix() = default;
+
+    // Method to compute the matrix for all columns of a panel
+    static SpreadVarianceMatrix compute(const PricePanel& panel);
+
+    std::size_t size() const;
+
+    // Spread variance of columns i and j, and a bound on its rounding error against a two-pass computation.
+    // Subtracting covariances cancels badly for closely related columns, so the bound scales with E[a^2] + E[b^2]
+    double variance(std::size_t i, std::size_t j) const;
+    double errorBound(std::size_t i, std::size_t j) const;
+
+    // Method to get a value the exact spread standard deviation of columns i and j cannot be below
+    double standardDeviationLowerBound(std::size_t i, std::size_t j) const;
+
+    const Eigen::MatrixXd& getVariances() const;
+
+private:
+    Eigen::MatrixXd variances;        // symbols x symbols, symmetric
+    Eigen::VectorXd secondMoments;    // Mean of the squared values of each column
+    double relativeError = 0.0;       // Error bound per unit of E[a^2] + E[b^2]
+};
+
+#endif // SPREADVARIANCEMATRIX_HPP
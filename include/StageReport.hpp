@@ -0,0 +1,34 @@
+#ifndef STAGEREPORT_HPP
+#define STAGEREPORT_HPP
+
+#include "ThreadPool.hpp"
+
+// Wall time of the named stages of a pipeline, with the per-thread utilisation of its parallel stages
+class StageReport {
+public:
+    // Method to record a serial stage; a stage recorded again under the same name is added to
+    void addStage(const std::string& name, double wallSeconds);
+
+    // Method to record a parallel stage from the timing of its pool loops
+    void addStage(const std::string& name, const ThreadPool::RunStatistics& statistics);
+
+    // Method to print one line per stage, in the order they were first recorded
+    void print(std::ostream& os = std::cout) const;
+
+    // Seconds elapsed since a start time, for timing serial stages
+    static double secondsSince(std::chrono::steady_clock::time_point start);
+
+private:
+    struct Stage {
+        std::string name;
+        double wallSeconds = 0.0;
+        bool parallel = false;
+        ThreadPool::RunStatistics statistics;
+    };
+
+    std::vector<Stage> stages;
+
+    Stage& findOrAdd(const std::string& name);
+};
+
+#endif // STAGEREPORT_HPP
@@ -22,8 +22,32 @@ public:
     };
 
     // Linear regression: Returns intercept, slope, and their standard errors
+    // Closed form for the single regressor: one pass over the data, no heap allocation
     static LinearRegressionResult 
-    linearRegression(const Eigen::VectorXd& x, const Eigen::VectorXd& y);
+    linearRegression(const Eigen::Ref<const Eigen::VectorXd>& x, const Eigen::Ref<const Eigen::VectorXd>& y);
+
+    // Running sums for a regression on the chronological index, fed one value at a time
+    class IndexRegressionAccumulator {
+    public:
+        void add(double y);
+        std::size_t count() const { return n; }
+        LinearRegressionResult result() const;
+
+    private:
+        std::size_t n = 0;
+        double shift = 0.0;                // First value; the sums are taken around it
+        double sum = 0.0;
+        double sumSquares = 0.0;
+        double sumIndexProducts = 0.0;     // Sum of i * (y_i - shift)
+    };
+
+    // Regression of y on its chronological index 0 .. n-1, whose sums are known in closed form
+    static LinearRegressionResult 
+    linearRegressionOnIndex(const Eigen::Ref<const Eigen::VectorXd>& y);
+
+    // Batched form: regress every column of ys on the shared x; results[j] is the fit of column j
+    static void linearRegression(const Eigen::Ref<const Eigen::VectorXd>& x, const Eigen::Ref<const Eigen::MatrixXd>& ys,
+                                 std::vector<LinearRegressionResult>& results);
 
 	// Wrapper/s for linear regression function
 	static LinearRegressionResult 
@@ -78,6 +102,10 @@ public:
     static double calculatePValue(double testStatistic, int degreesOfFreedom, const std::string& testType);
 
 private:
+    // Helper to turn the centred sums of a simple regression into its result
+    static LinearRegressionResult regressionFromMoments(double n, double meanX, double meanY,
+                                                        double sxx, double sxy, double syy);
+
     // Internal helper functions
     static double calculatePValue(double tStatistic, int degreesOfFreedom);
     static double fStatistic(const std::vector<Eigen::VectorXd>& groups);
@@ -2,6 +2,11 @@
 #define STOCK_HPP
 
 #include "Common.hpp"
+#include "Date.hpp"
+#include <array>
+#include <memory>
+
+class PrefixSumIndex;
 
 class Stock {
 public:
@@ -11,11 +16,22 @@ public:
     // Define the outer map type for holding historical data with date as the key
     using HistoricalData = std::unordered_map<std::string, DataMap>;
 
+    // Price fields stored as contiguous columns, one value per trading day
+    enum class Field : std::size_t { Open = 0, High, Low, Close, AdjClose, Volume };
+    static constexpr std::size_t FIELD_COUNT = 6;
+
+    using Column = std::vector<double>;
+    using Columns = std::array<Column, FIELD_COUNT>;
+
+    // Returned by the row lookups when a date is not present
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
     // Constructor and Destructor
     Stock() = default;
     ~Stock() = default;
 
-    // Method to add a data entry for a specific date and key
+    // Method to add a data entry for a specific date and key. Dates in YYYY-MM-DD form go into the columns; any other
+    // key is kept as given, outside the date axis, and only reached through getData and getHistoricalData
     void addData(const std::string& date, const std::string& key, double value);
 
     // Method to retrieve data for a specific date and key
@@ -25,10 +41,67 @@ public:
     void printHistoricalData() const;
 
 	// Method to retrieve all historical data
-	const Stock::HistoricalData& getHistoricalData() const;
+	// Compatibility view: the nested map is materialized from the columns on first use. The returned snapshot stays
+	// valid after later changes to the stock, which build a new view rather than alter this one
+	std::shared_ptr<const Stock::HistoricalData> getHistoricalData() const;
+
+    // Method to reserve capacity for a number of trading days
+    void reserve(std::size_t rows);
+
+    // Method to append a full row; rows arriving in date order are appended in O(1)
+    void appendRow(Date date, double open, double high, double low,
+                   double close, double adjClose, double volume);
+
+    // Method to replace all data with prebuilt columns (sorted and de-duplicated if needed)
+    void assignColumns(std::vector<Date>&& newDates, Columns&& newColumns);
+
+    // Method to remove all data
+    void clear();
+
+    // Number of trading days held; empty() is true only without undated entries as well
+    std::size_t size() const;
+    bool empty() const;
+
+    // Approximate heap memory held by the data, in bytes
+    std::size_t memoryUsage() const;
+
+    // Sorted date axis and the column of a given field aligned with it
+    const std::vector<Date>& getDates() const;
+    const Column& getColumn(Field field) const;
+
+    // Method to find the row of a date via binary search; returns npos if absent
+    std::size_t findDate(Date date) const;
+    std::size_t findDate(const std::string& date) const;
+
+    // Method to find the half-open row range [first, last) of dates within [startDate, endDate]
+    std::pair<std::size_t, std::size_t> getRange(Date startDate, Date endDate) const;
+
+    // String overload for callers at the I/O boundary; throws std::invalid_argument for an invalid date
+    std::pair<std::size_t, std::size_t> getRange(const std::string& startDate, const std::string& endDate) const;
+
+    // Prefix sums over the columns, built on first use and shared by later range queries; like getHistoricalData,
+    // the returned index is a snapshot that outlives later changes to the stock
+    std::shared_ptr<const PrefixSumIndex> getPrefixSums() const;
+
+    // Map between field names ("open", "high", "low", "close", "adj close", "volume") and columns
+    static bool parseField(const std::string& name, Field& field);
+    static const std::string& fieldName(Field field);
 
 private:
-    HistoricalData historicalData; // Holds the historical data
+    std::vector<Date> dates;                       // Sorted trading days
+    Columns columns;                               // One value per date for every field; NaN when missing
+    std::map<std::string, Column> extraColumns;    // Columns for keys outside the OHLCV set
+    HistoricalData undatedData;                    // Entries added under keys that are not YYYY-MM-DD dates
+
+    // Lazily materialized nested map backing getHistoricalData()
+    mutable std::shared_ptr<const HistoricalData> historicalDataView;
+
+    // Lazily built prefix sums backing getPrefixSums()
+    mutable std::shared_ptr<const PrefixSumIndex> prefixSums;
+
+    // Helper functions
+    std::size_t insertDate(Date date);
+    void invalidateViews();
 };
 
-#endif // STOCK_H
\ No newline at end of file
+#endif // STOCK_H
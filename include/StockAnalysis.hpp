@@ -16,6 +16,9 @@ public:
 	// Calculate both mean and standard deviation, with caching
     static std::pair<double, double> calculateStatistics(const std::unordered_map<std::string, double>& data);
 
+	// Overload for a contiguous series such as a PricePanel column; not cached
+    static std::pair<double, double> calculateStatistics(const Eigen::Ref<const Eigen::VectorXd>& data);
+
 	// Method to clear cache
 	static void clearCache();
 	
@@ -36,12 +39,25 @@ public:
         const std::unordered_map<std::string, double>& data
     );
 
+    // Series overloads: inputs are date-sorted views and the result is written into a caller-provided buffer.
+    // The buffer may be the storage of the first input (in-place), never of the second one.
+    static SeriesView calculateDifferenceBetweenData(SeriesView data1, SeriesView data2, Series& out);
+    static SeriesView normalizeToEarliestDate(SeriesView data, Series& out);
+    static SeriesView normalizeToReferenceData(SeriesView dataToNormalize, SeriesView referenceData, Series& out);
+    static SeriesView applyMapOperation(SeriesView data, const std::function<double(double)>& operation, Series& out);
+
 	// Method to check if a stock has valid data within a specified range
     static bool hasValidDataInRange(
         const Stock& stock1, const Stock& stock2, const std::string& priceType,
         const std::string& startDate, const std::string& endDate
     );
 
+	// Overload that reports the reason of a failed check through failureReason instead of printing it
+    static bool hasValidDataInRange(
+        const Stock& stock1, const Stock& stock2, const std::string& priceType,
+        const std::string& startDate, const std::string& endDate, std::string* failureReason
+    );
+
 	// Method to calculate the price-volume of certain price type of a Stock on a specific date
     static double calculatePriceVolume(const Stock& stock, const std::string& date, const std::string& priceType = "close");
 
@@ -61,8 +77,31 @@ public:
 	static double calculatePValueForURT(
     const std::unordered_map<std::string, double>& data,
     const std::string& testType, int lags, const std::string& trend,
+    const std::string& method, const std::string& lagLength = "");
+
+	// Overload for a series already in chronological order, such as a spread of PricePanel columns
+	static double calculatePValueForURT(
+    const Eigen::Ref<const Eigen::VectorXd>& series,
+    const std::string& testType, int lags, const std::string& trend,
     const std::string& method, const std::string& lagLength = "");
 	
+	// p-values of the unit-root battery reported for every selected pair
+	struct UnitRootPValues {
+		double adfAIC;
+		double adfBIC;
+		double ppShortRho;
+		double ppLongRho;
+		double ppShortTau;
+		double ppLongTau;
+		double kpssShort;
+		double kpssLong;
+	};
+
+	// Method to run the whole battery (ADF AIC/BIC, PP rho/tau short/long, KPSS short/long) on one chronological series.
+	// The series is converted once and shared by all eight tests; throws on the first test that fails
+	static UnitRootPValues calculateUnitRootBattery(
+    const Eigen::Ref<const Eigen::VectorXd>& series, int lags, const std::string& trend);
+	
 	// Utility function for creating cacheKeys
 	static std::string makeCacheKey(const std::string& stock1, const std::string& stock2);
 	
@@ -78,6 +117,12 @@ public:
 	);
 	
 private:
+    // Helper running one unit-root test on a series already in URT's vector type
+    static double runUnitRootTest(
+    const Eigen::VectorXd& prices,
+    const std::string& testType, int lags, const std::string& trend,
+    const std::string& method, const std::string& lagLength);
+
     // Cache for calculated statistics; uses the address of the dataset as the key
     static std::unordered_map<const std::unordered_map<std::string, double>*, std::pair<double, double>> statisticsCache;
 };
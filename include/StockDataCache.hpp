@@ -0,0 +1,65 @@
+#ifndef STOCKDATACACHE_HPP
+#define STOCKDATACACHE_HPP
+
+#include "Stock.hpp"
+#include "FileReader.hpp"
+#include <cstdint>
+
+// Binary columnar cache of a parsed stock data file, stored alongside the text file.
+//
+// Layout (host byte order):
+//   Header                  128 bytes, see below
+//   Date block              rowCount x int32 day numbers (see Date), padded to BLOCK_ALIGNMENT
+//   Column blocks           FIELD_COUNT x rowCount doubles in Stock::Field order, each padded to BLOCK_ALIGNMENT
+//   Warning block           warningSampleCount x (uint32 length, message bytes), the sample of the parse's LoadReport
+//
+// The header keeps the warning counts of the parse, so a load served from the cache reports what the text file would.
+// A cache is valid only while the size and modification time of its source file match the header.
+class StockDataCache {
+public:
+    static constexpr char MAGIC[8] = {'S', 'A', 'C', 'O', 'L', 'C', 'H', 'E'};
+    static constexpr std::uint32_t FORMAT_VERSION = 3;
+    static constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+    static constexpr std::size_t BLOCK_ALIGNMENT = 64;
+
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byteOrderMark;
+        std::uint64_t rowCount;
+        std::uint64_t sourceSize;
+        std::int64_t sourceModifiedTime;
+        std::uint64_t dateBlockOffset;
+        std::uint64_t columnBlockOffset;
+        std::uint64_t columnBlockStride;
+        std::uint64_t linesRead;
+        std::uint64_t malformedLines;
+        std::uint64_t invalidFormatLines;
+        std::uint64_t outOfRangeLines;
+        std::uint64_t warningBlockOffset;
+        std::uint64_t warningSampleCount;
+        std::uint64_t reserved[2];
+    };
+    static_assert(sizeof(Header) == 128, "Cache header must stay 128 bytes");
+
+    // Method to derive the cache file path for a source file
+    static std::string getCachePath(const std::string& sourceFile);
+
+    // Method to check whether an up-to-date cache exists for a source file
+    static bool isFresh(const std::string& sourceFile);
+
+    // Method to read the cache of a source file into column buffers and the warnings of its parse into report;
+    // returns false if missing, stale or corrupt
+    static bool load(const std::string& sourceFile, std::vector<Date>& dates, Stock::Columns& columns,
+                     FileReader::LoadReport& report);
+
+    // Method to write the cache for a source file from a loaded Stock and the report of its parse; returns false if it
+    // could not be written
+    static bool write(const std::string& sourceFile, const Stock& stock, const FileReader::LoadReport& report);
+
+private:
+    // Size and modification time of a source file
+    static bool getSourceStamp(const std::string& sourceFile, std::uint64_t& size, std::int64_t& modifiedTime);
+};
+
+#endif // STOCKDATACACHE_HPP
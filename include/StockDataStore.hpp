@@ -0,0 +1,78 @@
+#ifndef STOCKDATASTORE_HPP
+#define STOCKDATASTORE_HPP
+
+#include "Stock.hpp"
+#include "FileReader.hpp"
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+
+// Shared, thread-safe store of loaded stock data files.
+// Each file is loaded at most once while it stays resident; concurrent requests for the same file wait for a
+// single load. With a memory budget set, the least recently used entries are evicted once it is exceeded.
+// Evicted data stays alive for as long as callers hold the returned pointers.
+class StockDataStore {
+public:
+    struct Statistics {
+        std::size_t hits = 0;             // Requests served from a resident (or in-flight) entry
+        std::size_t misses = 0;           // Requests that had to load the file
+        std::size_t loadFailures = 0;     // Misses for files that could not be opened
+        std::size_t evictions = 0;
+        std::size_t residentEntries = 0;
+        std::size_t bytesResident = 0;    // Memory held by resident entries
+        std::size_t bytesLoaded = 0;      // Memory loaded over the lifetime of the store
+    };
+
+    // A budget of 0 means unlimited
+    explicit StockDataStore(std::size_t memoryBudgetBytes = 0);
+
+    StockDataStore(const StockDataStore&) = delete;
+    StockDataStore& operator=(const StockDataStore&) = delete;
+
+    // Process-wide store, created with Config::STORE_MEMORY_BUDGET_BYTES
+    static StockDataStore& instance();
+
+    // Method to fetch a stock data file, loading it on first use; returns nullptr if the file cannot be opened.
+    // The report of the load that produced the entry is copied into report when given
+    std::shared_ptr<const Stock> get(const std::string& filename, FileReader::LoadReport* report = nullptr);
+
+    // Convenience overload building the file path the way the selection code does
+    std::shared_ptr<const Stock> get(const std::string& stockDataDir, const std::string& symbol,
+                                     const std::string& fileExtension, FileReader::LoadReport* report = nullptr);
+
+    // Method to check whether a file is currently resident
+    bool contains(const std::string& filename) const;
+
+    // Method to change the memory budget, evicting immediately if needed
+    void setMemoryBudget(std::size_t memoryBudgetBytes);
+    std::size_t getMemoryBudget() const;
+
+    // Method to drop every resident entry; statistics are kept
+    void clear();
+
+    Statistics getStatistics() const;
+    void printStatistics(std::ostream& os = std::cout) const;
+
+private:
+    using StockPointer = std::shared_ptr<const Stock>;
+
+    struct Entry {
+        std::shared_future<StockPointer> stock;
+        FileReader::LoadReport loadReport;
+        std::size_t bytes = 0;
+        bool ready = false;
+        std::list<std::string>::iterator lruPosition; // Valid only once ready
+    };
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+    std::list<std::string> lruOrder; // Most recently used first
+    std::size_t memoryBudget;
+    Statistics statistics;
+
+    // Helper function to evict least recently used entries until the budget holds; requires the lock
+    void evictToBudget();
+};
+
+#endif // STOCKDATASTORE_HPP
@@ -3,6 +3,7 @@
 
 #include "Common.hpp"
 #include "Stock.hpp"
+#include "SeriesView.hpp"
 
 class StockUtils {
 public:
@@ -11,6 +12,21 @@ public:
     static std::unordered_map<std::string, double> getPriceDataInRange(
         const Stock& stock, const std::string& priceType, const std::string& startDate, const std::string& endDate
     );
+
+    // Zero-copy view of a column's rows within [startDate, endDate]; missing values read as NaN
+    static SeriesView getPriceSeriesInRange(const Stock& stock, Stock::Field field, Date startDate, Date endDate);
+
+    // Copy the valid values of a price type within a date range into a caller-provided buffer
+    static SeriesView getPriceSeriesInRange(
+        const Stock& stock, const std::string& priceType, const std::string& startDate, const std::string& endDate,
+        Series& out
+    );
+
+    // Conversions between date-keyed dictionaries and series; toSeries throws std::invalid_argument for a key that is not a date,
+    // tryToSeries returns false instead
+    static SeriesView toSeries(const std::unordered_map<std::string, double>& data, Series& out);
+    static bool tryToSeries(const std::unordered_map<std::string, double>& data, Series& out);
+    static std::unordered_map<std::string, double> toMap(SeriesView series);
 };
 
 #endif // STOCKUTILS_H
\ No newline at end of file
@@ -0,0 +1,29 @@
+#ifndef SYMBOLTABLE_HPP
+#define SYMBOLTABLE_HPP
+
+#include "Common.hpp"
+#include <cstdint>
+
+// Intern table giving every distinct symbol a small integer id, assigned in first-seen order.
+// Records keep the id; the name is looked up only when output is written.
+class SymbolTable {
+public:
+    using SymbolId = std::uint32_t;
+
+    // Method to get the id of a symbol, adding it on first use
+    SymbolId intern(const std::string& symbol);
+
+    // Id of a symbol already interned; throws std::out_of_range for any other symbol
+    SymbolId id(const std::string& symbol) const;
+
+    // Name of an id returned by intern; throws std::out_of_range for any other id
+    const std::string& name(SymbolId id) const;
+
+    std::size_t size() const;
+
+private:
+    std::unordered_map<std::string, SymbolId> ids;
+    std::vector<std::string> names;   // Indexed by id
+};
+
+#endif // SYMBOLTABLE_HPP
@@ -0,0 +1,31 @@
+#ifndef TEXTBUFFER_HPP
+#define TEXTBUFFER_HPP
+
+#include "Common.hpp"
+#include "Date.hpp"
+
+// Growable text buffer formatting values with std::to_chars. Numbers come out as a default-formatted std::ostream
+// writes them (doubles as %g with 6 significant digits), without the stream's locale and state handling.
+class TextBuffer {
+public:
+    TextBuffer& operator<<(double value);
+    TextBuffer& operator<<(int value);
+    TextBuffer& operator<<(long value);
+    TextBuffer& operator<<(unsigned long value);
+    TextBuffer& operator<<(const std::string& text);
+    TextBuffer& operator<<(const char* text);
+    TextBuffer& operator<<(char character);
+    TextBuffer& operator<<(Date date);   // As YYYY-MM-DD
+
+    const std::string& str() const;
+    std::string& str();
+    std::size_t size() const;
+    bool empty() const;
+    void clear();
+    void reserve(std::size_t capacity);
+
+private:
+    std::string text;
+};
+
+#endif // TEXTBUFFER_HPP
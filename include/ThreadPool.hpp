@@ -0,0 +1,89 @@
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include "Common.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Fixed set of worker threads that run index-parallel loops; the calling thread takes part as worker 0.
+// A loop is cut into chunks and every worker starts on its own contiguous share of them; a worker that runs out
+// steals chunks from the back of the other shares, so uneven items still keep every thread busy.
+class ThreadPool {
+public:
+    // Signature of a loop body: the item index and the id of the worker running it (0 .. size()-1)
+    using Task = std::function<void(std::size_t index, unsigned int worker)>;
+
+    // Signature of a chunked loop body: the items [begin, end) and the id of the worker running them
+    using ChunkTask = std::function<void(std::size_t begin, std::size_t end, unsigned int worker)>;
+
+    // Timing of one parallel loop
+    struct RunStatistics {
+        double wallSeconds = 0.0;
+        std::vector<double> busySeconds;      // Time each worker spent inside the loop body
+        std::vector<std::size_t> chunksRun;   // Chunks each worker ran, stolen ones included
+        std::size_t steals = 0;
+
+        // Share of the available worker time spent in the loop body, in [0, 1]
+        double utilisation() const;
+
+        // Method to add the timing of another loop, e.g. to total the loops of one stage
+        void accumulate(const RunStatistics& other);
+    };
+
+    // A thread count of 0 uses the hardware concurrency
+    explicit ThreadPool(unsigned int threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Number of workers, including the calling thread
+    unsigned int size() const;
+
+    // Method to run task(i) for every i in [0, count) and wait for all of them; rethrows the first exception
+    void parallelFor(std::size_t count, const Task& task);
+
+    // Method to run task over [0, count) in chunks of chunkSize items and wait for all of them; rethrows the first exception
+    void parallelForChunks(std::size_t count, std::size_t chunkSize, const ChunkTask& task);
+
+    // Timing of the most recent loop
+    const RunStatistics& getLastRunStatistics() const;
+
+    // Resolve a requested thread count (0 = hardware concurrency) to an actual one
+    static unsigned int resolveThreadCount(unsigned int requested);
+
+private:
+    // Share of the chunks of the current loop owned by one worker; the owner takes from the front, thieves from the back
+    struct ChunkQueue {
+        std::mutex mutex;
+        std::size_t front = 0;
+        std::size_t back = 0;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<ChunkQueue>> queues;
+    std::mutex mutex;
+    std::condition_variable jobAvailable;
+    std::condition_variable jobFinished;
+
+    // State of the loop currently being run
+    const ChunkTask* currentTask = nullptr;
+    std::size_t taskCount = 0;
+    std::size_t taskChunkSize = 1;
+    unsigned int activeWorkers = 0;
+    std::uint64_t generation = 0;
+    bool stopping = false;
+    std::exception_ptr firstError;
+    std::atomic<std::size_t> stealCount{0};
+    RunStatistics lastRun;
+
+    void workerLoop(unsigned int worker);
+    void runChunks(unsigned int worker);
+    bool takeChunk(unsigned int worker, std::size_t& chunk);
+};
+
+#endif // THREADPOOL_HPP
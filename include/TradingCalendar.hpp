@@ -0,0 +1,52 @@
+#ifndef TRADINGCALENDAR_HPP
+#define TRADINGCALENDAR_HPP
+
+#include "Stock.hpp"
+
+// Ordered set of trading sessions with O(1) mapping from any date in its span to a dense session index
+class TradingCalendar {
+public:
+    // Returned by sessionIndex for dates that are not sessions
+    static constexpr std::int32_t NO_SESSION = -1;
+
+    TradingCalendar() = default;
+
+    // Build from sorted, unique session dates
+    explicit TradingCalendar(std::vector<Date> sessionDates);
+
+    // Method to build the calendar from the days a reference stock (e.g. SPY) has valid, non-zero data for a field
+    static TradingCalendar fromStock(const Stock& reference, Stock::Field field = Stock::Field::Close);
+
+    // Method to build the calendar from all weekdays in [firstDay, lastDay] except the given holidays
+    static TradingCalendar fromHolidays(Date firstDay, Date lastDay, const std::vector<Date>& holidays);
+
+    std::size_t size() const;
+    bool empty() const;
+    const std::vector<Date>& getSessions() const;
+    Date getSession(std::size_t index) const;
+
+    // Method to map a date to its session index; NO_SESSION if it is not a session
+    std::int32_t sessionIndex(Date date) const;
+    bool isSession(Date date) const;
+
+    // Method to find the first session on or after a date (size() if none)
+    std::size_t lowerBound(Date date) const;
+
+    // Method to find the half-open session index range [first, last) within [startDate, endDate]
+    std::pair<std::size_t, std::size_t> getRange(Date startDate, Date endDate) const;
+
+    // Method to step to the next session after a date; throws std::out_of_range past the last session
+    Date nextSession(Date date) const;
+
+    // Method to check that a stock has valid, non-zero data for a field on exactly the sessions in [startDate, endDate]
+    bool isAligned(const Stock& stock, Stock::Field field, Date startDate, Date endDate,
+                   std::string* failureReason = nullptr) const;
+
+private:
+    std::vector<Date> sessions;
+    Date firstDay;
+    // For every calendar day from firstDay to the last session: index of the first session on or after it
+    std::vector<std::int32_t> sessionAtOrAfter;
+};
+
+#endif // TRADINGCALENDAR_HPP
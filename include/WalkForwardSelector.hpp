@@ -0,0 +1,75 @@
+#ifndef WALKFORWARDSELECTOR_HPP
+#define WALKFORWARDSELECTOR_HPP
+
+#include <Eigen/Dense>
+#include "PricePanel.hpp"
+#include "GreedyPairing.hpp"
+#include "Config.hpp"
+
+// Walk-forward distance selection over a formation window sliding one session at a time across a panel.
+// Running sums of every symbol (sum a, sum a^2) and of every pair (sum ab) are kept about a per-symbol shift, so a
+// slide costs one rank-1 update to add the new session and one to drop the oldest: O(symbols^2) instead of the
+// O(sessions x symbols^2) of recomputing. Prices are normalised to the window's first session only when a pair is
+// scored, which leaves the sums valid as the window moves. The sums are rebuilt exactly, about fresh shifts, every
+// recomputeInterval slides to stop rounding drift; the error bounds widen with the slides since the last rebuild.
+class WalkForwardSelector {
+public:
+    // Greedy pairing of one formation window
+    struct Rebalance {
+        Date date;                                // Last session of the formation window
+        std::size_t firstSession;                 // Panel row of the window's first session
+        std::vector<GreedyPairing::Pair> pairs;   // Panel columns, scored by spread standard deviation
+    };
+
+    // The panel must hold raw prices (not normalised) and outlive the selector; the window starts at the first session.
+    // Throws std::invalid_argument if the window is shorter than two sessions or longer than the panel, or if
+    // recomputeInterval is zero
+    WalkForwardSelector(const PricePanel& panel, std::size_t windowLength,
+                        std::size_t recomputeInterval = Config::WALK_FORWARD_RECOMPUTE_INTERVAL);
+
+    // Method to slide the window forward by one session; returns false, leaving it in place, at the end of the panel
+    bool advance();
+
+    std::size_t getWindowStart() const;
+    std::size_t getWindowLength() const;
+    Date getWindowEndDate() const;
+
+    // Population variance of the normalised spread of columns i and j over the current window, and a bound on its
+    // rounding error against a two-pass computation
+    double spreadVariance(std::size_t i, std::size_t j) const;
+    double errorBound(std::size_t i, std::size_t j) const;
+
+    // Method to get a value the exact spread standard deviation of columns i and j cannot be below
+    double standardDeviationLowerBound(std::size_t i, std::size_t j) const;
+
+    // Two-pass spread standard deviation over the current window, the score the pairing decides on
+    double exactStandardDeviation(std::size_t i, std::size_t j) const;
+
+    // Method to run the greedy pairing on the current window, in panel column order
+    std::vector<GreedyPairing::Pair> selectPairs() const;
+
+    // Method to walk a window of windowLength sessions across the panel and pair it every rebalanceInterval sessions,
+    // starting with the first full window
+    static std::vector<Rebalance> run(const PricePanel& panel, std::size_t windowLength, std::size_t rebalanceInterval,
+                                      std::size_t recomputeInterval = Config::WALK_FORWARD_RECOMPUTE_INTERVAL);
+
+private:
+    const PricePanel* panel;
+    std::size_t windowLength;
+    std::size_t recomputeInterval;
+    std::size_t windowStart = 0;
+    std::size_t slidesSinceRecompute = 0;
+
+    Eigen::VectorXd shifts;             // Per-symbol value the sums are taken about
+    Eigen::VectorXd sums;               // Sum of (a - shift) over the window
+    Eigen::MatrixXd crossProducts;      // Lower triangle of sum (a - shift)(b - shift) over the window
+    Eigen::VectorXd absoluteMagnitudes; // Sum of |a - shift| over every value added since the last rebuild
+    Eigen::VectorXd squareMagnitudes;   // Sum of (a - shift)^2 over every value added since the last rebuild
+    Eigen::VectorXd entering, leaving;  // Shifted rows of one slide
+    mutable Eigen::VectorXd spread;     // Buffer of exactStandardDeviation
+
+    // Helper function to rebuild the sums of the current window about the window means
+    void recompute();
+};
+
+#endif // WALKFORWARDSELECTOR_HPP
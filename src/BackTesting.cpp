@@ -2,7 +2,7 @@
 
 // Constructor
 BackTesting::BackTesting(double initialBalance)
-    : initialBalance(initialBalance), currentBalance(initialBalance) {}
+    : initialBalance(initialBalance), currentBalance(initialBalance), metrics(initialBalance) {}
 
 // Getters
 double BackTesting::getInitialBalance(){return initialBalance;}
@@ -16,47 +16,35 @@ double BackTesting::calculateCumulativeReturn() const {
 
 // Calculate Sharpe ratio
 double BackTesting::calculateSharpeRatio() const {
-    if (trades.empty()) return 0.0;
-
-    double meanReturn = 0.0;
-    double variance = 0.0;
-    std::vector<double> returns;
-
-    for (const auto& trade : trades) {
-        double tradeReturn = trade.profitLoss / initialBalance;
-        returns.push_back(tradeReturn);
-        meanReturn += tradeReturn;
-    }
-    meanReturn /= trades.size();
-
-    for (const auto& r : returns) {
-        variance += (r - meanReturn) * (r - meanReturn);
-    }
-    double stddev = std::sqrt(variance / trades.size());
-
-    return stddev == 0.0 ? 0.0 : meanReturn / stddev;
+    return metrics.tradeSharpeRatio();
 }
 
 // Calculate maximum drawdown
 double BackTesting::calculateMaximumDrawdown() const {
-    double maxBalance = initialBalance;
-    double runningBalance = initialBalance;  // Track balance incrementally
-    double maxDrawdown = 0.0;
+    return metrics.maxDrawdown();
+}
 
-    for (const auto& trade : trades) {
-        runningBalance += trade.profitLoss;  // Update balance with each trade
-        if (runningBalance > maxBalance) maxBalance = runningBalance;
-        double drawdown = (maxBalance - runningBalance) / maxBalance;
-        if (drawdown > maxDrawdown) maxDrawdown = drawdown;
-    }
+const PerformanceMetrics& BackTesting::getMetrics() const {
+    return metrics;
+}
+
+const std::vector<BackTesting::Trade>& BackTesting::getTrades() const {
+    return trades;
+}
 
-    return maxDrawdown;
+Date BackTesting::getSessionDate(std::uint32_t session) const {
+    return calendar->getSession(session);
+}
+
+const std::string& BackTesting::getSymbolName(SymbolTable::SymbolId symbol) const {
+    return symbols->name(symbol);
 }
 
 // Record a trade
 void BackTesting::recordTrade(const Trade& trade) {
     trades.push_back(trade);
     currentBalance += trade.profitLoss;
+    metrics.addTrade(trade.profitLoss);
 }
 
 // Log results
@@ -67,26 +55,58 @@ void BackTesting::logResults(const std::string& filename) const {
         return;
     }
 	
-	// Write the header of the file
-    file << "EntryDate,ExitDate";
-	for(auto element : trades.at(0).entryPrices){
-		file << "," << element.first << " Entry Price";
-	}
-	for(auto element : trades.at(0).exitPrices){
-		file << "," << element.first << " Exit Price";
-	}
-	file << ",ProfitLoss\n";
-	
-	// Write the trades information into the file
+	TextBuffer text;
+	writeTradeHeader(text);
+	writeTradeRows(text);
+	text << '\n';
+	file << text.str();
+}
+
+// Resolve the sessions of a trade
+BackTesting::TradeRow BackTesting::resolveTrade(const Trade& trade) const {
+    return {calendar->getSession(trade.entrySession), calendar->getSession(trade.exitSession), trade.entryPrices,
+        trade.exitPrices, trade.profitLoss};
+}
+
+std::array<std::string, BackTesting::LEG_COUNT> BackTesting::getLegNames() const {
+    std::array<std::string, LEG_COUNT> legNames;
+    for (std::size_t leg = 0; leg < LEG_COUNT; ++leg) {
+        legNames[leg] = symbols->name(legs[leg]);
+    }
+    return legNames;
+}
+
+// Write the header line of the trades file
+void BackTesting::writeTradeHeader(TextBuffer& out, const std::array<std::string, LEG_COUNT>& legNames) {
+    out << "EntryDate,ExitDate";
+    for (std::size_t leg = 0; leg < LEG_COUNT; ++leg) {
+        out << "," << legNames[leg] << " Entry Price";
+    }
+    for (std::size_t leg = 0; leg < LEG_COUNT; ++leg) {
+        out << "," << legNames[leg] << " Exit Price";
+    }
+    out << ",ProfitLoss\n";
+}
+
+void BackTesting::writeTradeHeader(TextBuffer& out) const {
+    writeTradeHeader(out, getLegNames());
+}
+
+// Write the line of one trade
+void BackTesting::writeTradeRow(TextBuffer& out, const TradeRow& row) {
+    out << row.entryDate << "," << row.exitDate;
+    for (std::size_t leg = 0; leg < LEG_COUNT; ++leg) {
+        out << "," << row.entryPrices[leg];
+    }
+    for (std::size_t leg = 0; leg < LEG_COUNT; ++leg) {
+        out << "," << row.exitPrices[leg];
+    }
+    out << "," << row.profitLoss << "\n";
+}
+
+// Write one line per trade
+void BackTesting::writeTradeRows(TextBuffer& out) const {
     for (const auto& trade : trades) {
-        file << trade.entryDate << "," << trade.exitDate << ",";
-		for(auto element : trade.entryPrices){
-			file << element.second << ",";
-		}
-		for(auto element : trade.exitPrices){
-			file << element.second << ",";
-		}
-		file << trade.profitLoss << "\n";
+        writeTradeRow(out, resolveTrade(trade));
     }
-	file << "\n";
 }
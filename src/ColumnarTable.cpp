@@ -0,0 +1,516 @@
+#include "ColumnarTable.hpp"
+#include <cstring>
+#include <limits>
+
+namespace {
+    std::uint64_t alignUp(std::uint64_t value) {
+        return (value + ColumnarTable::BLOCK_ALIGNMENT - 1) / ColumnarTable::BLOCK_ALIGNMENT * ColumnarTable::BLOCK_ALIGNMENT;
+    }
+
+    // Helper function to read a value of a column chunk as a double
+    double readValue(const char* chunk, ColumnarTable::ColumnType type, std::size_t row) {
+        switch (type) {
+            case ColumnarTable::ColumnType::Float64: {
+                double value;
+                std::memcpy(&value, chunk + row * sizeof(value), sizeof(value));
+                return value;
+            }
+            case ColumnarTable::ColumnType::Int64: {
+                std::int64_t value;
+                std::memcpy(&value, chunk + row * sizeof(value), sizeof(value));
+                return static_cast<double>(value);
+            }
+            case ColumnarTable::ColumnType::Date: {
+                std::int32_t value;
+                std::memcpy(&value, chunk + row * sizeof(value), sizeof(value));
+                return static_cast<double>(value);
+            }
+            case ColumnarTable::ColumnType::String: {
+                std::uint32_t value;
+                std::memcpy(&value, chunk + row * sizeof(value), sizeof(value));
+                return static_cast<double>(value);
+            }
+        }
+        return 0.0;
+    }
+
+    bool compare(ColumnarTable::Reader::Comparison comparison, double value, double bound) {
+        switch (comparison) {
+            case ColumnarTable::Reader::Comparison::Less: return value < bound;
+            case ColumnarTable::Reader::Comparison::LessEqual: return value <= bound;
+            case ColumnarTable::Reader::Comparison::Greater: return value > bound;
+            case ColumnarTable::Reader::Comparison::GreaterEqual: return value >= bound;
+            case ColumnarTable::Reader::Comparison::Equal: return value == bound;
+            case ColumnarTable::Reader::Comparison::NotEqual: return value != bound;
+        }
+        return false;
+    }
+
+    // Helper function to tell whether no value of a chunk can pass a comparison. NaN fails every comparison but
+    // NotEqual, so only that one needs the NaN count; the others are written with negations so a chunk of NaN only
+    // (min +inf, max -inf) is ruled out exactly when its rows would fail
+    bool rangeExcludes(ColumnarTable::Reader::Comparison comparison, double bound, double min, double max,
+                       std::uint64_t nanCount) {
+        switch (comparison) {
+            case ColumnarTable::Reader::Comparison::Less: return !(min < bound);
+            case ColumnarTable::Reader::Comparison::LessEqual: return !(min <= bound);
+            case ColumnarTable::Reader::Comparison::Greater: return !(max > bound);
+            case ColumnarTable::Reader::Comparison::GreaterEqual: return !(max >= bound);
+            case ColumnarTable::Reader::Comparison::Equal: return !(min <= bound && bound <= max);
+            case ColumnarTable::Reader::Comparison::NotEqual: return nanCount == 0 && min == bound && max == bound;
+        }
+        return false;
+    }
+
+    // Filter with its column and bound resolved against a file
+    struct ResolvedFilter {
+        std::size_t column;
+        ColumnarTable::Reader::Comparison comparison;
+        double bound;
+    };
+}
+
+constexpr char ColumnarTable::MAGIC[8];
+
+// Width in bytes of one value of a column type
+std::size_t ColumnarTable::valueWidth(ColumnType type) {
+    switch (type) {
+        case ColumnType::Float64: return sizeof(double);
+        case ColumnType::Int64: return sizeof(std::int64_t);
+        case ColumnType::Date: return sizeof(std::int32_t);
+        case ColumnType::String: return sizeof(std::uint32_t);
+    }
+    throw std::invalid_argument("Unknown column type.");
+}
+
+// Create the file and leave room for the header
+ColumnarTable::Writer::Writer(const std::string& filename, std::vector<Column> columns, std::size_t blockRows)
+    : file(filename, std::ios::binary | std::ios::trunc), columns(std::move(columns)), blockRows(std::max<std::size_t>(blockRows, 1)) {
+    if (!file) {
+        throw std::runtime_error("Could not create the columnar file: " + filename);
+    }
+    chunks.resize(this->columns.size());
+    for (std::size_t c = 0; c < this->columns.size(); ++c) {
+        chunks[c].reserve(this->blockRows * valueWidth(this->columns[c].type));
+    }
+    minimums.assign(this->columns.size(), std::numeric_limits<double>::infinity());
+    maximums.assign(this->columns.size(), -std::numeric_limits<double>::infinity());
+    nanCounts.assign(this->columns.size(), 0);
+    padTo(sizeof(Header));
+}
+
+ColumnarTable::Writer::~Writer() {
+    close();
+}
+
+void ColumnarTable::Writer::addDouble(double value) {
+    add(ColumnType::Float64, &value, value);
+}
+
+void ColumnarTable::Writer::addInteger(std::int64_t value) {
+    add(ColumnType::Int64, &value, static_cast<double>(value));
+}
+
+void ColumnarTable::Writer::addDate(Date value) {
+    const std::int32_t dayNumber = value.dayNumber();
+    add(ColumnType::Date, &dayNumber, dayNumber);
+}
+
+void ColumnarTable::Writer::addString(const std::string& value) {
+    // Checked before interning, so a rejected value does not enter the dictionary
+    if (nextColumn < columns.size() && columns[nextColumn].type == ColumnType::String) {
+        const std::uint32_t index = dictionary.intern(value);
+        add(ColumnType::String, &index, index);
+    } else {
+        add(ColumnType::String, nullptr, 0.0);
+    }
+}
+
+// Store the next value of the row
+void ColumnarTable::Writer::add(ColumnType type, const void* value, double rangeValue) {
+    if (nextColumn >= columns.size()) {
+        throw std::invalid_argument("The row already has a value for every column.");
+    }
+    if (columns[nextColumn].type != type) {
+        throw std::invalid_argument("Column " + columns[nextColumn].name + " does not take a value of this type.");
+    }
+
+    std::vector<char>& chunk = chunks[nextColumn];
+    const char* bytes = static_cast<const char*>(value);
+    chunk.insert(chunk.end(), bytes, bytes + valueWidth(type));
+    if (rangeValue < minimums[nextColumn]) minimums[nextColumn] = rangeValue;
+    if (rangeValue > maximums[nextColumn]) maximums[nextColumn] = rangeValue;
+    if (std::isnan(rangeValue)) nanCounts[nextColumn]++;
+    nextColumn++;
+}
+
+// Finish the row
+void ColumnarTable::Writer::endRow() {
+    if (nextColumn != columns.size()) {
+        throw std::invalid_argument("The row has no value for column " + columns[nextColumn].name + ".");
+    }
+    nextColumn = 0;
+    blockRowCount++;
+    totalRows++;
+    if (blockRowCount == blockRows) writeBlock();
+}
+
+// Write the current block and its footer
+void ColumnarTable::Writer::writeBlock() {
+    if (blockRowCount == 0) return;
+
+    std::vector<ChunkSummary> summaries(columns.size());
+    for (std::size_t c = 0; c < columns.size(); ++c) {
+        padTo(alignUp(offset));
+        summaries[c] = {offset, minimums[c], maximums[c], nanCounts[c]};
+        write(chunks[c].data(), chunks[c].size());
+        chunks[c].clear();
+        minimums[c] = std::numeric_limits<double>::infinity();
+        maximums[c] = -std::numeric_limits<double>::infinity();
+        nanCounts[c] = 0;
+    }
+
+    padTo(alignUp(offset));
+    footerOffsets.push_back(offset);
+    const std::uint64_t rows = blockRowCount;
+    write(&rows, sizeof(rows));
+    write(summaries.data(), summaries.size() * sizeof(ChunkSummary));
+    blockRowCount = 0;
+}
+
+// Write the last block, the schema, the dictionary and the index, then the header
+bool ColumnarTable::Writer::close() {
+    if (closed) return static_cast<bool>(file);
+    closed = true;
+
+    // A row left unfinished is dropped
+    for (std::size_t c = 0; c < nextColumn; ++c) {
+        chunks[c].resize(chunks[c].size() - valueWidth(columns[c].type));
+    }
+    nextColumn = 0;
+    writeBlock();
+
+    Header header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = FORMAT_VERSION;
+    header.byteOrderMark = BYTE_ORDER_MARK;
+    header.columnCount = static_cast<std::uint32_t>(columns.size());
+    header.blockRows = static_cast<std::uint32_t>(blockRows);
+    header.rowCount = totalRows;
+    header.blockCount = footerOffsets.size();
+
+    padTo(alignUp(offset));
+    header.schemaOffset = offset;
+    for (const Column& column : columns) {
+        const std::uint32_t type = static_cast<std::uint32_t>(column.type);
+        const std::uint32_t length = static_cast<std::uint32_t>(column.name.size());
+        write(&type, sizeof(type));
+        write(&length, sizeof(length));
+        write(column.name.data(), column.name.size());
+    }
+
+    padTo(alignUp(offset));
+    header.dictionaryOffset = offset;
+    const std::uint64_t entries = dictionary.size();
+    write(&entries, sizeof(entries));
+    for (std::uint64_t i = 0; i < entries; ++i) {
+        const std::string& text = dictionary.name(static_cast<SymbolTable::SymbolId>(i));
+        const std::uint32_t length = static_cast<std::uint32_t>(text.size());
+        write(&length, sizeof(length));
+        write(text.data(), text.size());
+    }
+
+    padTo(alignUp(offset));
+    header.blockIndexOffset = offset;
+    write(footerOffsets.data(), footerOffsets.size() * sizeof(std::uint64_t));
+
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.close();
+    return !file.fail();
+}
+
+const std::vector<ColumnarTable::Column>& ColumnarTable::Writer::getColumns() const {
+    return columns;
+}
+
+std::uint64_t ColumnarTable::Writer::rowCount() const {
+    return totalRows;
+}
+
+void ColumnarTable::Writer::write(const void* data, std::size_t size) {
+    file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    offset += size;
+}
+
+// Write zero padding up to an offset
+void ColumnarTable::Writer::padTo(std::uint64_t target) {
+    static const char zeros[sizeof(Header) > BLOCK_ALIGNMENT ? sizeof(Header) : BLOCK_ALIGNMENT] = {};
+    write(zeros, static_cast<std::size_t>(target - offset));
+}
+
+ColumnarTable::Reader::Filter::Filter(std::string column, Comparison comparison, double value)
+    : column(std::move(column)), comparison(comparison), value(value) {}
+
+ColumnarTable::Reader::Filter::Filter(std::string column, Comparison comparison, Date value)
+    : column(std::move(column)), comparison(comparison), value(value.dayNumber()) {}
+
+ColumnarTable::Reader::Filter::Filter(std::string column, Comparison comparison, std::string text)
+    : column(std::move(column)), comparison(comparison), text(std::move(text)) {}
+
+// Map the file and read everything but the blocks
+ColumnarTable::Reader::Reader(const std::string& filename) {
+    if (!file.open(filename)) {
+        throw std::runtime_error("Could not open the columnar file: " + filename);
+    }
+    if (file.size() < sizeof(Header)) {
+        throw std::runtime_error("Not a columnar result file: " + filename);
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        header.version != FORMAT_VERSION ||
+        header.byteOrderMark != BYTE_ORDER_MARK) {
+        throw std::runtime_error("Not a columnar result file: " + filename);
+    }
+
+    readSchema();
+    readDictionary();
+    readBlockIndex();
+}
+
+void ColumnarTable::Reader::readSchema() {
+    std::uint64_t position = header.schemaOffset;
+
+    // Every column takes at least its type and name length, which bounds the count before anything is allocated
+    checkArray(position, header.columnCount, sizeof(std::uint32_t) * 2);
+    columns.resize(header.columnCount);
+    for (Column& column : columns) {
+        std::uint32_t type, length;
+        checkRange(position, sizeof(type) + sizeof(length));
+        std::memcpy(&type, file.data() + position, sizeof(type));
+        std::memcpy(&length, file.data() + position + sizeof(type), sizeof(length));
+        position += sizeof(type) + sizeof(length);
+        if (type > static_cast<std::uint32_t>(ColumnType::String)) {
+            throw std::runtime_error("The columnar file has a column of unknown type.");
+        }
+        checkRange(position, length);
+        column.name.assign(file.data() + position, length);
+        column.type = static_cast<ColumnType>(type);
+        position += length;
+    }
+}
+
+void ColumnarTable::Reader::readDictionary() {
+    std::uint64_t position = header.dictionaryOffset;
+    std::uint64_t entries;
+    checkRange(position, sizeof(entries));
+    std::memcpy(&entries, file.data() + position, sizeof(entries));
+    position += sizeof(entries);
+
+    // Every entry takes at least its length, which bounds the count before anything is allocated
+    checkArray(position, entries, sizeof(std::uint32_t));
+    dictionary.reserve(static_cast<std::size_t>(entries));
+    for (std::uint64_t i = 0; i < entries; ++i) {
+        std::uint32_t length;
+        checkRange(position, sizeof(length));
+        std::memcpy(&length, file.data() + position, sizeof(length));
+        position += sizeof(length);
+        checkRange(position, length);
+        dictionary.emplace_back(file.data() + position, length);
+        position += length;
+    }
+}
+
+// Read the footer offsets and check every footer and chunk lies inside the file
+void ColumnarTable::Reader::readBlockIndex() {
+    checkArray(header.blockIndexOffset, header.blockCount, sizeof(std::uint64_t));
+    footerOffsets.resize(static_cast<std::size_t>(header.blockCount));
+    if (!footerOffsets.empty()) {
+        std::memcpy(footerOffsets.data(), file.data() + header.blockIndexOffset, footerOffsets.size() * sizeof(std::uint64_t));
+    }
+
+    std::uint64_t rows = 0;
+    for (std::uint64_t footerOffset : footerOffsets) {
+        checkRange(footerOffset, sizeof(std::uint64_t) + columns.size() * sizeof(ChunkSummary));
+        std::uint64_t blockRows;
+        std::memcpy(&blockRows, file.data() + footerOffset, sizeof(blockRows));
+        for (std::size_t c = 0; c < columns.size(); ++c) {
+            ChunkSummary summary;
+            std::memcpy(&summary, file.data() + footerOffset + sizeof(blockRows) + c * sizeof(ChunkSummary), sizeof(summary));
+            checkArray(summary.offset, blockRows, valueWidth(columns[c].type));
+        }
+        rows += blockRows;
+    }
+    if (rows != header.rowCount) {
+        throw std::runtime_error("The columnar file's blocks do not add up to its row count.");
+    }
+}
+
+void ColumnarTable::Reader::checkRange(std::uint64_t offset, std::uint64_t size) const {
+    if (offset > file.size() || size > file.size() - offset) {
+        throw std::runtime_error("The columnar file is truncated or corrupt.");
+    }
+}
+
+// Check count values of width bytes fit from offset on, without forming a product that could overflow
+void ColumnarTable::Reader::checkArray(std::uint64_t offset, std::uint64_t count, std::uint64_t width) const {
+    if (offset > file.size() || count > (file.size() - offset) / width) {
+        throw std::runtime_error("The columnar file is truncated or corrupt.");
+    }
+}
+
+const std::vector<ColumnarTable::Column>& ColumnarTable::Reader::getColumns() const {
+    return columns;
+}
+
+std::uint64_t ColumnarTable::Reader::rowCount() const {
+    return header.rowCount;
+}
+
+std::size_t ColumnarTable::Reader::blockCount() const {
+    return footerOffsets.size();
+}
+
+// Get the index of a column by name
+std::size_t ColumnarTable::Reader::columnIndex(const std::string& name) const {
+    for (std::size_t c = 0; c < columns.size(); ++c) {
+        if (columns[c].name == name) return c;
+    }
+    throw std::invalid_argument("The columnar file has no column " + name + ".");
+}
+
+// Call callback for every row passing all filters
+ColumnarTable::Reader::ScanStatistics ColumnarTable::Reader::scan(const std::vector<std::string>& projection,
+    const std::vector<Filter>& filters, const RowCallback& callback) const {
+    std::vector<std::size_t> projected;
+    if (projection.empty()) {
+        for (std::size_t c = 0; c < columns.size(); ++c) projected.push_back(c);
+    } else {
+        for (const std::string& name : projection) projected.push_back(columnIndex(name));
+    }
+
+    // Resolve string filters to dictionary indices once; every filter is checked before any early return, so a bad
+    // call fails whatever the data holds
+    ScanStatistics statistics;
+    std::vector<ResolvedFilter> resolved;
+    bool matchesNothing = false;
+    for (const Filter& filter : filters) {
+        const std::size_t column = columnIndex(filter.column);
+        if (columns[column].type != ColumnType::String) {
+            resolved.push_back({column, filter.comparison, filter.value});
+            continue;
+        }
+        if (filter.comparison != Comparison::Equal && filter.comparison != Comparison::NotEqual) {
+            throw std::invalid_argument("Only Equal and NotEqual apply to the string column " + filter.column + ".");
+        }
+        auto entry = std::find(dictionary.begin(), dictionary.end(), filter.text);
+        if (entry == dictionary.end()) {
+            // A value missing from the dictionary matches no row, or every row
+            if (filter.comparison == Comparison::Equal) matchesNothing = true;
+            continue;
+        }
+        resolved.push_back({column, filter.comparison, static_cast<double>(entry - dictionary.begin())});
+    }
+    if (matchesNothing) {
+        statistics.blocksSkipped = footerOffsets.size();
+        return statistics;
+    }
+
+    std::vector<ChunkSummary> summaries(columns.size());
+    std::vector<const char*> chunks(columns.size());
+    std::vector<unsigned char> selected;
+    RowView view;
+    view.reader = this;
+    view.columns = &projected;
+    view.chunks = &chunks;
+
+    for (std::uint64_t footerOffset : footerOffsets) {
+        std::uint64_t blockRows;
+        std::memcpy(&blockRows, file.data() + footerOffset, sizeof(blockRows));
+        std::memcpy(summaries.data(), file.data() + footerOffset + sizeof(blockRows), summaries.size() * sizeof(ChunkSummary));
+
+        bool skip = false;
+        for (const ResolvedFilter& filter : resolved) {
+            const ChunkSummary& summary = summaries[filter.column];
+            if (rangeExcludes(filter.comparison, filter.bound, summary.min, summary.max, summary.nanCount)) {
+                skip = true;
+                break;
+            }
+        }
+        if (skip) {
+            statistics.blocksSkipped++;
+            continue;
+        }
+        statistics.blocksRead++;
+
+        for (std::size_t c = 0; c < columns.size(); ++c) {
+            chunks[c] = file.data() + summaries[c].offset;
+        }
+
+        // Apply the filters a column at a time
+        const std::size_t rows = static_cast<std::size_t>(blockRows);
+        selected.assign(rows, 1);
+        for (const ResolvedFilter& filter : resolved) {
+            const char* chunk = chunks[filter.column];
+            const ColumnType type = columns[filter.column].type;
+            for (std::size_t row = 0; row < rows; ++row) {
+                if (selected[row]) selected[row] = compare(filter.comparison, readValue(chunk, type, row), filter.bound);
+            }
+        }
+
+        for (std::size_t row = 0; row < rows; ++row) {
+            if (!selected[row]) continue;
+            view.row = row;
+            callback(view);
+            statistics.rowsMatched++;
+        }
+    }
+    return statistics;
+}
+
+std::size_t ColumnarTable::Reader::RowView::size() const {
+    return columns->size();
+}
+
+// Cell of a projected column, checked against the type asked for
+const char* ColumnarTable::Reader::RowView::cell(std::size_t i, ColumnType type) const {
+    const std::size_t column = columns->at(i);
+    if (reader->columns[column].type != type) {
+        throw std::invalid_argument("Column " + reader->columns[column].name + " is not of the requested type.");
+    }
+    return (*chunks)[column] + row * valueWidth(type);
+}
+
+double ColumnarTable::Reader::RowView::getDouble(std::size_t i) const {
+    double value;
+    std::memcpy(&value, cell(i, ColumnType::Float64), sizeof(value));
+    return value;
+}
+
+std::int64_t ColumnarTable::Reader::RowView::getInteger(std::size_t i) const {
+    std::int64_t value;
+    std::memcpy(&value, cell(i, ColumnType::Int64), sizeof(value));
+    return value;
+}
+
+Date ColumnarTable::Reader::RowView::getDate(std::size_t i) const {
+    std::int32_t value;
+    std::memcpy(&value, cell(i, ColumnType::Date), sizeof(value));
+    return Date::fromDayNumber(value);
+}
+
+const std::string& ColumnarTable::Reader::RowView::getString(std::size_t i) const {
+    std::uint32_t value;
+    std::memcpy(&value, cell(i, ColumnType::String), sizeof(value));
+    return reader->dictionary.at(value);
+}
+
+// Value of a numeric or date column as a double
+double ColumnarTable::Reader::RowView::getValue(std::size_t i) const {
+    const std::size_t column = columns->at(i);
+    const ColumnType type = reader->columns[column].type;
+    if (type == ColumnType::String) {
+        throw std::invalid_argument("Column " + reader->columns[column].name + " holds strings, not numbers.");
+    }
+    return readValue((*chunks)[column], type, row);
+}
@@ -3,4 +3,15 @@
 const std::string Config::DATA_DIR = "data/";
 const std::string Config::NYSE_LISTINGS_FILE = "NYSE_listings.txt";
 const std::string Config::STOCK_DATA_DIR = "stock_data/";
-const std::string Config::OUTPUT_DIR = "output/";
\ No newline at end of file
+const std::string Config::OUTPUT_DIR = "output/";
+const std::string Config::CACHE_FILE_EXTENSION = ".col";
+const bool Config::USE_BINARY_CACHE = true;
+const unsigned int Config::THREAD_COUNT = 0;
+const std::size_t Config::STORE_MEMORY_BUDGET_BYTES = 0;
+const std::size_t Config::GRAM_MATRIX_MAX_SYMBOLS = 8000;
+const bool Config::REPORT_STAGE_TIMINGS = true;
+const std::size_t Config::WALK_FORWARD_RECOMPUTE_INTERVAL = 64;
+const std::size_t Config::RESULT_SINK_BUFFER_SIZE = 1 << 20;
+const bool Config::WRITE_COLUMNAR_RESULTS = false;
+const std::string Config::COLUMNAR_RESULT_EXTENSION = ".sacol";
+const std::size_t Config::COLUMNAR_BLOCK_ROWS = 65536;
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "Date.hpp"
+#include <stdexcept>
+
+// Conversions use the days-from-civil algorithm (H. Hinnant), valid for the whole int32 range of years used here
+
+Date Date::fromCivil(int year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+    const unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return Date(era * 146097 + static_cast<int>(dayOfEra) - 719468);
+}
+
+void Date::toCivil(int& year, unsigned& month, unsigned& day) const {
+    const int z = days + 719468;
+    const int era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned dayOfEra = static_cast<unsigned>(z - era * 146097);
+    const unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const unsigned monthIndex = (5 * dayOfYear + 2) / 153;
+    day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    year = static_cast<int>(yearOfEra) + era * 400 + (month <= 2);
+}
+
+// Parse a YYYY-MM-DD date in place
+bool Date::parse(const char* first, const char* last, Date& date) {
+    if (last - first != 10 || first[4] != '-' || first[7] != '-') return false;
+
+    unsigned digits[8];
+    const int positions[8] = {0, 1, 2, 3, 5, 6, 8, 9};
+    for (int i = 0; i < 8; ++i) {
+        char c = first[positions[i]];
+        if (c < '0' || c > '9') return false;
+        digits[i] = static_cast<unsigned>(c - '0');
+    }
+
+    const int year = static_cast<int>(digits[0] * 1000 + digits[1] * 100 + digits[2] * 10 + digits[3]);
+    const unsigned month = digits[4] * 10 + digits[5];
+    const unsigned day = digits[6] * 10 + digits[7];
+    if (month < 1 || month > 12 || day < 1) return false;
+
+    static const unsigned DAYS_IN_MONTH[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    const bool leapYear = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    const unsigned monthLength = DAYS_IN_MONTH[month - 1] + (month == 2 && leapYear ? 1 : 0);
+    if (day > monthLength) return false;
+
+    date = fromCivil(year, month, day);
+    return true;
+}
+
+bool Date::parse(const std::string& text, Date& date) {
+    return parse(text.data(), text.data() + text.size(), date);
+}
+
+Date Date::parse(const std::string& text) {
+    Date date;
+    if (!parse(text, date)) {
+        throw std::invalid_argument("Invalid date, expected YYYY-MM-DD: " + text);
+    }
+    return date;
+}
+
+// Write the date as YYYY-MM-DD
+char* Date::format(char* out) const {
+    int year;
+    unsigned month, day;
+    toCivil(year, month, day);
+    unsigned y = static_cast<unsigned>(year);
+    out[0] = static_cast<char>('0' + y / 1000 % 10);
+    out[1] = static_cast<char>('0' + y / 100 % 10);
+    out[2] = static_cast<char>('0' + y / 10 % 10);
+    out[3] = static_cast<char>('0' + y % 10);
+    out[4] = '-';
+    out[5] = static_cast<char>('0' + month / 10);
+    out[6] = static_cast<char>('0' + month % 10);
+    out[7] = '-';
+    out[8] = static_cast<char>('0' + day / 10);
+    out[9] = static_cast<char>('0' + day % 10);
+    return out + 10;
+}
+
+std::string Date::toString() const {
+    char buffer[10];
+    format(buffer);
+    return std::string(buffer, sizeof(buffer));
+}
+
+// Day of the week; 1970-01-01 was a Thursday
+int Date::weekday() const {
+    return days >= -4 ? (days + 4) % 7 : (days + 5) % 7 + 6;
+}
+
+bool Date::isWeekend() const {
+    int day = weekday();
+    return day == 0 || day == 6;
+}
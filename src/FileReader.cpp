@@ -1,56 +1,234 @@
 #include "FileReader.hpp"
+#include "MappedFile.hpp"
+#include "StockDataCache.hpp"
+#include "Config.hpp"
+#include <charconv>
+#include <cstring>
+
+namespace {
+    // Outcome of parsing one numeric field, mirroring the exceptions std::stod would throw
+    enum class FieldStatus { Ok, InvalidFormat, OutOfRange };
+
+    // Helper function to parse a double in place; like std::stod it skips leading whitespace and ignores trailing characters
+    FieldStatus parseNumber(const char* first, const char* last, double& value) {
+        while (first != last && std::isspace(static_cast<unsigned char>(*first))) ++first;
+        if (first != last && *first == '+' && first + 1 != last && *(first + 1) != '-' && *(first + 1) != '+') ++first;
+
+        auto result = std::from_chars(first, last, value);
+        if (result.ec == std::errc::invalid_argument) return FieldStatus::InvalidFormat;
+        if (result.ec == std::errc::result_out_of_range) return FieldStatus::OutOfRange;
+        return FieldStatus::Ok;
+    }
+
+    // Helper function to keep the first few warning messages of a load
+    void addWarning(FileReader::LoadReport& report, const char* message, std::size_t lineNumber,
+                    const char* lineBegin, const char* lineEnd) {
+        if (report.sampleWarnings.size() >= FileReader::MAX_WARNING_SAMPLES) return;
+        if (lineEnd != lineBegin && *(lineEnd - 1) == '\r') --lineEnd;
+        report.sampleWarnings.push_back(std::string(message) + std::to_string(lineNumber) + ": " + std::string(lineBegin, lineEnd));
+    }
+}
 
 bool FileReader::loadStockDataFromFile(const std::string& filename, Stock& stock) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
+    LoadReport report;
+    bool loaded = loadStockDataFromFile(filename, stock, report);
+    if (!loaded) {
         std::cerr << "Could not open the file: " << filename << "\n";
+    } else if (report.warningCount() > 0) {
+        printLoadReport(filename, report);
+    }
+    return loaded;
+}
+
+bool FileReader::loadStockDataFromFile(const std::string& filename, Stock& stock, LoadReport& report) {
+    report = LoadReport();
+
+    // Prefer the binary cache while it matches the text file
+    if (Config::USE_BINARY_CACHE) {
+        std::vector<Date> dates;
+        Stock::Columns columns;
+        if (StockDataCache::load(filename, dates, columns, report)) {
+            report.fileOpened = true;
+            report.loadedFromCache = true;
+            report.rowsLoaded = dates.size();
+
+            Stock cached;
+            cached.assignColumns(std::move(dates), std::move(columns));
+            mergeInto(stock, std::move(cached));
+            return true;
+        }
+    }
+
+    Stock parsed;
+    if (!parseTextFile(filename, parsed, report)) {
         return false;
     }
 
-    std::string line;
-    int lineNumber = 0; // Keep track of the line number for error messages
+    // A failed cache write (e.g. read-only data directory) only costs the next run a re-parse
+    if (Config::USE_BINARY_CACHE) {
+        StockDataCache::write(filename, parsed, report);
+    }
 
-    while (std::getline(file, line)) {
+    mergeInto(stock, std::move(parsed));
+    return true;
+}
+
+// Build binary caches for every listing that lacks an up-to-date one
+std::size_t FileReader::warmCache(const std::string& listingsFile, const std::string& stockDataDir, const std::string& fileExtension) {
+    std::size_t written = 0;
+    for (const auto& listing : readNYSEListings(listingsFile)) {
+        const std::string filename = stockDataDir + listing + fileExtension;
+        if (StockDataCache::isFresh(filename)) continue;
+
+        Stock parsed;
+        LoadReport report;
+        if (!parseTextFile(filename, parsed, report)) {
+            std::cerr << "Could not open the file: " << filename << "\n";
+            continue;
+        }
+        if (report.warningCount() > 0) {
+            printLoadReport(filename, report);
+        }
+        if (StockDataCache::write(filename, parsed, report)) {
+            written++;
+        } else {
+            std::cerr << "Warning FileReader::warmCache: could not write cache for " << filename << "\n";
+        }
+    }
+    return written;
+}
+
+// Parse a text stock data file
+bool FileReader::parseTextFile(const std::string& filename, Stock& parsed, LoadReport& report) {
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        return false;
+    }
+    report.fileOpened = true;
+
+    // Parse straight into per-column buffers, sized from a typical line length
+    std::vector<Date> dates;
+    Stock::Columns columns;
+    std::size_t expectedRows = file.size() / 48 + 1;
+    dates.reserve(expectedRows);
+    for (auto& column : columns) column.reserve(expectedRows);
+
+    // Fields in file order: date, open, high, low, close, adj close, volume
+    constexpr std::size_t NUMERIC_FIELDS = 6;
+    constexpr Stock::Field FILE_ORDER[NUMERIC_FIELDS] = {
+        Stock::Field::Open, Stock::Field::High, Stock::Field::Low,
+        Stock::Field::Close, Stock::Field::AdjClose, Stock::Field::Volume
+    };
+    // Conversion order of the original loader, which decides the reported error when several fields are bad
+    constexpr std::size_t CONVERSION_ORDER[NUMERIC_FIELDS] = {4, 3, 1, 2, 0, 5};
+
+    const char* cursor = file.data();
+    const char* const end = cursor + file.size();
+    std::size_t lineNumber = 0; // Keep track of the line number for error messages
+
+    while (cursor != end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(cursor, '\n', static_cast<std::size_t>(end - cursor)));
+        if (lineEnd == nullptr) lineEnd = end;
+        const char* lineBegin = cursor;
+        cursor = lineEnd == end ? end : lineEnd + 1;
         lineNumber++;
-        std::istringstream iss(line);
-        std::string date, adjClose, close, high, low, open, volume;
-
-        // Read each expected field from the line
-        if (std::getline(iss, date, ',') && 
-            std::getline(iss, open, ',') &&
-            std::getline(iss, high, ',') &&
-            std::getline(iss, low, ',') &&
-            std::getline(iss, close, ',') &&
-            std::getline(iss, adjClose, ',') &&
-            std::getline(iss, volume)) {
-            
-			// Trim date string
-			date = trimInternal(date);
-            try {
-                // Convert and add data only if conversion is successful
-                stock.addData(date, "adj close", std::stod(adjClose));
-                stock.addData(date, "close", std::stod(close));
-                stock.addData(date, "high", std::stod(high));
-                stock.addData(date, "low", std::stod(low));
-                stock.addData(date, "open", std::stod(open));
-                stock.addData(date, "volume", std::stod(volume));
-            } catch (const std::invalid_argument& e) {
-                std::cerr << "Warning FileReader::loadStockDataFromFile: Invalid data format at line " << lineNumber << ": " << line << "\n";
-                continue; // Skip this line and move to the next
-            } catch (const std::out_of_range& e) {
-                std::cerr << "Warning FileReader::loadStockDataFromFile: Number out of range at line " << lineNumber << ": " << line << "\n";
-                continue; // Skip this line and move to the next
+
+        // Split the line: six comma-terminated fields, then the volume runs to the end of the line
+        const char* fieldBegin[NUMERIC_FIELDS + 1];
+        const char* fieldEnd[NUMERIC_FIELDS + 1];
+        const char* pos = lineBegin;
+        bool complete = true;
+        for (std::size_t f = 0; f < NUMERIC_FIELDS; ++f) {
+            const char* comma = static_cast<const char*>(std::memchr(pos, ',', static_cast<std::size_t>(lineEnd - pos)));
+            if (comma == nullptr) {
+                complete = false;
+                break;
             }
-        } else {
-            std::cerr << "Warning FileReader::loadStockDataFromFile: Malformed line at " << lineNumber << ": " << line << "\n";
+            fieldBegin[f] = pos;
+            fieldEnd[f] = comma;
+            pos = comma + 1;
+        }
+        if (!complete || pos == lineEnd) {
+            report.malformedLines++;
+            addWarning(report, "Malformed line at ", lineNumber, lineBegin, lineEnd);
             continue; // Skip this line and move to the next
         }
+        fieldBegin[NUMERIC_FIELDS] = pos;
+        fieldEnd[NUMERIC_FIELDS] = lineEnd;
+
+        // Convert the numeric fields; the row is only kept if all of them convert
+        double values[NUMERIC_FIELDS];
+        FieldStatus status = FieldStatus::Ok;
+        for (std::size_t k = 0; k < NUMERIC_FIELDS && status == FieldStatus::Ok; ++k) {
+            std::size_t f = CONVERSION_ORDER[k];
+            status = parseNumber(fieldBegin[f + 1], fieldEnd[f + 1], values[f]);
+        }
+        if (status == FieldStatus::InvalidFormat) {
+            report.invalidFormatLines++;
+            addWarning(report, "Invalid data format at line ", lineNumber, lineBegin, lineEnd);
+            continue;
+        }
+        if (status == FieldStatus::OutOfRange) {
+            report.outOfRangeLines++;
+            addWarning(report, "Number out of range at line ", lineNumber, lineBegin, lineEnd);
+            continue;
+        }
+
+        // Trim date string and convert it to a day number
+        const char* dateEnd = fieldEnd[0];
+        while (dateEnd != fieldBegin[0] && std::isspace(static_cast<unsigned char>(*(dateEnd - 1)))) --dateEnd;
+        Date date;
+        if (!Date::parse(fieldBegin[0], dateEnd, date)) {
+            report.invalidFormatLines++;
+            addWarning(report, "Invalid data format at line ", lineNumber, lineBegin, lineEnd);
+            continue;
+        }
+        dates.push_back(date);
+        for (std::size_t f = 0; f < NUMERIC_FIELDS; ++f) {
+            columns[static_cast<std::size_t>(FILE_ORDER[f])].push_back(values[f]);
+        }
     }
+    report.linesRead = lineNumber;
+    report.rowsLoaded = dates.size();
 
-    file.close();
+    parsed.assignColumns(std::move(dates), std::move(columns));
     return true;
 }
 
+// Merge loaded rows into a possibly non-empty Stock
+void FileReader::mergeInto(Stock& stock, Stock&& loaded) {
+    if (stock.empty()) {
+        stock = std::move(loaded);
+        return;
+    }
+
+    // Later rows overwrite earlier ones like repeated addData calls
+    const auto& dates = loaded.getDates();
+    stock.reserve(stock.size() + dates.size());
+    for (std::size_t row = 0; row < dates.size(); ++row) {
+        stock.appendRow(dates[row],
+                        loaded.getColumn(Stock::Field::Open)[row],
+                        loaded.getColumn(Stock::Field::High)[row],
+                        loaded.getColumn(Stock::Field::Low)[row],
+                        loaded.getColumn(Stock::Field::Close)[row],
+                        loaded.getColumn(Stock::Field::AdjClose)[row],
+                        loaded.getColumn(Stock::Field::Volume)[row]);
+    }
+}
+
+// Print the warning summary of a load
+void FileReader::printLoadReport(const std::string& filename, const LoadReport& report, std::ostream& os) {
+    os << "Warning FileReader::loadStockDataFromFile: " << filename << ": skipped " << report.warningCount()
+       << " of " << report.linesRead << " lines (" << report.malformedLines << " malformed, "
+       << report.invalidFormatLines << " invalid format, " << report.outOfRangeLines << " out of range)\n";
+    for (const auto& warning : report.sampleWarnings) {
+        os << "  " << warning << "\n";
+    }
+    if (report.warningCount() > report.sampleWarnings.size()) {
+        os << "  ... " << report.warningCount() - report.sampleWarnings.size() << " more\n";
+    }
+}
+
 std::vector<std::string> FileReader::readNYSEListings(const std::string& filename) {
     std::vector<std::string> nyseListings;
     std::ifstream file(filename);
@@ -0,0 +1,86 @@
+#include "GreedyPairing.hpp"
+
+namespace {
+    // Helper list of the unpaired items in listing order, with O(1) removal
+    class UnpairedList {
+    public:
+        explicit UnpairedList(std::size_t count)
+            : next(count + 1), previous(count + 1), head(count) {
+            // Index count is the sentinel closing the ring
+            for (std::size_t i = 0; i <= count; ++i) {
+                next[i] = i == count ? 0 : i + 1;
+                previous[i] = i == 0 ? count : i - 1;
+            }
+            if (count == 0) next[head] = head;
+        }
+
+        std::size_t first() const { return next[head]; }
+        std::size_t after(std::size_t item) const { return next[item]; }
+        bool isEnd(std::size_t item) const { return item == head; }
+
+        void remove(std::size_t item) {
+            next[previous[item]] = next[item];
+            previous[next[item]] = previous[item];
+        }
+
+    private:
+        std::vector<std::size_t> next;
+        std::vector<std::size_t> previous;
+        std::size_t head;
+    };
+}
+
+// Pair items greedily in listing order
+std::vector<GreedyPairing::Pair> GreedyPairing::run(
+    std::size_t count, const BoundFunction& lowerBounds, const ScoreFunction& exactScore
+) {
+    std::vector<Pair> pairs;
+    pairs.reserve(count / 2);
+
+    UnpairedList unpaired(count);
+    std::vector<std::size_t> candidates;
+    std::vector<double> bounds;
+    std::vector<std::pair<double, std::size_t>> heap; // {lower bound, position in candidates}
+    std::greater<std::pair<double, std::size_t>> minFirst;
+
+    while (!unpaired.isEnd(unpaired.first())) {
+        const std::size_t base = unpaired.first();
+        unpaired.remove(base);
+
+        candidates.clear();
+        for (std::size_t item = unpaired.first(); !unpaired.isEnd(item); item = unpaired.after(item)) {
+            candidates.push_back(item);
+        }
+        if (candidates.empty()) break;
+
+        bounds.assign(candidates.size(), 0.0);
+        lowerBounds(base, candidates, bounds);
+
+        heap.clear();
+        for (std::size_t k = 0; k < candidates.size(); ++k) heap.emplace_back(bounds[k], k);
+        std::make_heap(heap.begin(), heap.end(), minFirst);
+
+        // Best candidate so far by (exact score, listing position); a bound equal to the best score may still tie
+        // with an earlier candidate, so only a strictly larger bound ends the search
+        double bestScore = 0.0;
+        std::size_t bestPosition = candidates.size();
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), minFirst);
+            auto [bound, position] = heap.back();
+            heap.pop_back();
+            if (bestPosition != candidates.size() && bound > bestScore) break;
+
+            double score = exactScore(base, candidates[position]);
+            if (bestPosition == candidates.size() || score < bestScore || (score == bestScore && position < bestPosition)) {
+                bestScore = score;
+                bestPosition = position;
+            }
+        }
+
+        const std::size_t partner = candidates[bestPosition];
+        unpaired.remove(partner);
+        pairs.push_back({base, partner, bestScore});
+    }
+
+    return pairs;
+}
@@ -0,0 +1,183 @@
+#include "JobRunner.hpp"
+
+namespace {
+	// Helper function to strip the whitespace on both sides of a job file field
+	std::string trimField(const std::string& str) {
+		auto first = std::find_if(str.begin(), str.end(), [](unsigned char ch) { return !std::isspace(ch); });
+		return FileReader::trim(std::string(first, str.end()));
+	}
+}
+
+// Read the windows of a job file
+std::vector<JobRunner::Window> JobRunner::readJobFile(const std::string& filename) {
+	std::ifstream file(filename);
+	if (!file.is_open()) {
+		throw std::runtime_error("Could not open the job file: " + filename);
+	}
+
+	std::vector<Window> windows;
+	std::string line;
+	std::size_t lineNumber = 0;
+	while (std::getline(file, line)) {
+		lineNumber++;
+		line = trimField(line);
+		if (line.empty() || line[0] == '#') continue;
+
+		// Split into the four dates
+		std::vector<std::string> fields;
+		std::stringstream ss(line);
+		std::string field;
+		while (std::getline(ss, field, ',')) {
+			fields.push_back(trimField(field));
+		}
+
+		const std::string where = filename + " line " + std::to_string(lineNumber);
+		if (fields.size() != 4) {
+			throw std::runtime_error(where + ": expected formationStart,formationEnd,tradingStart,tradingEnd");
+		}
+		Date dates[4];
+		for (std::size_t i = 0; i < 4; ++i) {
+			if (!Date::parse(fields[i], dates[i])) {
+				throw std::runtime_error(where + ": invalid date \"" + fields[i] + "\"");
+			}
+		}
+		if (dates[0] > dates[1] || dates[2] > dates[3]) {
+			throw std::runtime_error(where + ": a window ends before it starts");
+		}
+
+		windows.push_back({fields[0], fields[1], fields[2], fields[3]});
+	}
+	return windows;
+}
+
+// Run every window into one consolidated result set
+std::size_t JobRunner::run(const std::vector<Window>& windows, const std::vector<std::string>& stockListings,
+	const Settings& settings, const std::string& resultsFile, const std::string& tradesFile) {
+	std::ofstream outFile(resultsFile);
+	if (!outFile.is_open()) {
+		std::cerr << "Error: Unable to open file " << resultsFile << "\n";
+		return 0;
+	}
+	outFile << "Formation Start,Formation End,Trading Start,Trading End," << PairsBackTestDriver::RESULT_HEADER << "\n";
+
+	// The trades of every window go to one fresh file
+	std::ofstream tradesOut(tradesFile);
+	if (!tradesOut.is_open()) {
+		std::cerr << "Error: Unable to open file " << tradesFile << "\n";
+		return 0;
+	}
+	bool tradesHeaderWritten = false;
+
+	// Columnar copies next to the text files, with the window dates as columns
+	std::unique_ptr<ColumnarTable::Writer> columnarResults, columnarTrades;
+	PairsBackTestDriver::ColumnarOutput columnar;
+	if (Config::WRITE_COLUMNAR_RESULTS) {
+		try {
+			columnarResults = std::make_unique<ColumnarTable::Writer>(
+				std::filesystem::path(resultsFile).replace_extension(Config::COLUMNAR_RESULT_EXTENSION).string(), PairsBackTestDriver::RESULT_COLUMNS);
+			columnarTrades = std::make_unique<ColumnarTable::Writer>(
+				std::filesystem::path(tradesFile).replace_extension(Config::COLUMNAR_RESULT_EXTENSION).string(), PairsBackTestDriver::TRADE_COLUMNS);
+			columnar.results = columnarResults.get();
+			columnar.trades = columnarTrades.get();
+		} catch (const std::exception& e) {
+			// The text files do not depend on the columnar copies, so the run goes on without them
+			std::cerr << "Error: " << e.what() << "\n";
+		}
+	}
+
+	PairsBackTestDriver::Settings driverSettings;
+	driverSettings.stockDataDir = settings.stockDataDir;
+	driverSettings.fileExtension = settings.fileExtension;
+	driverSettings.priceType = settings.priceType;
+	driverSettings.initialBalance = settings.initialBalance;
+	const PairsBackTestDriver::ConfigPolicy policy = PairsBackTestDriver::thresholdPolicy(
+		settings.entryMultiplier, settings.exitMultiplier, settings.tradeAmount, settings.slippage);
+
+	// Selections by formation period, so windows sharing one are selected once
+	std::map<std::pair<std::string, std::string>, std::map<std::string, PairsTradingBackTesting::PairStatistics>> selections;
+
+	std::size_t rowsWritten = 0;
+	for (std::size_t index = 0; index < windows.size(); ++index) {
+		const Window& window = windows[index];
+		const std::string windowName = window.formationStart + "-" + window.formationEnd + " / " +
+			window.tradingStart + "-" + window.tradingEnd;
+		std::cout << "Window " << index + 1 << " of " << windows.size() << ": formation " << window.formationStart << " to "
+				  << window.formationEnd << ", trading " << window.tradingStart << " to " << window.tradingEnd << "\n";
+
+		const auto formationPeriod = std::make_pair(window.formationStart, window.formationEnd);
+		auto selection = selections.find(formationPeriod);
+		if (selection == selections.end()) {
+			try {
+				selection = selections.emplace(formationPeriod, PairsTradingBackTesting::selectPairsForBackTesting(
+					stockListings, settings.stockDataDir, settings.fileExtension, settings.priceType,
+					window.formationStart, window.formationEnd, settings.priceVolumeThreshold)).first;
+			} catch (const std::exception& e) {
+				std::cerr << "Error processing window " << windowName << ": " << e.what() << "\n";
+				continue;
+			}
+		}
+
+		// Back-test the window's pairs concurrently and append them in pair order
+		const std::string rowPrefix = window.formationStart + "," + window.formationEnd + "," +
+			window.tradingStart + "," + window.tradingEnd + ",";
+		columnar.window = window;
+		rowsWritten += PairsBackTestDriver::runAndWrite(selection->second, window, driverSettings, policy,
+			outFile, tradesOut, tradesHeaderWritten, rowPrefix, columnar.results ? &columnar : nullptr);
+	}
+	outFile.close();
+	tradesOut.close();
+	if ((columnarResults && !columnarResults->close()) || (columnarTrades && !columnarTrades->close())) {
+		std::cerr << "Error: Unable to write the columnar results\n";
+	}
+
+	return rowsWritten;
+}
+
+// Pair the universe along a walk-forward formation window
+std::size_t JobRunner::runWalkForward(const std::vector<std::string>& stockListings, const Settings& settings,
+	const std::string& startDate, const std::string& endDate, std::size_t windowLength, std::size_t rebalanceInterval,
+	const std::string& pairingsFile) {
+	Date start, end;
+	if (!Date::parse(startDate, start) || !Date::parse(endDate, end) || start > end) {
+		throw std::invalid_argument("Invalid walk-forward range: " + startDate + " to " + endDate);
+	}
+	Stock::Field priceField;
+	if (!Stock::parseField(settings.priceType, priceField)) {
+		throw std::invalid_argument("Unknown price type: " + settings.priceType);
+	}
+
+	// The same liquid, fully traded universe the selection of one window uses, over the whole range
+	std::shared_ptr<const Stock> SPY = StockDataStore::instance().get(settings.stockDataDir, "SPY", settings.fileExtension);
+	if (!SPY) {
+		throw std::runtime_error("Could not load SPY for the trading calendar");
+	}
+	const TradingCalendar calendar = TradingCalendar::fromStock(*SPY, priceField);
+	ThreadPool threadPool(PairsTradingBackTesting::SelectionConfig().threadCount);
+	PairsTradingBackTesting::UniverseFilterResult universe = PairsTradingBackTesting::filterUniverse(stockListings,
+		settings.stockDataDir, settings.fileExtension, settings.priceType, startDate, endDate,
+		settings.priceVolumeThreshold, calendar, threadPool);
+	PairsTradingBackTesting::printFilterSummary(universe, startDate, endDate);
+	std::cout << "--------------------------------------------------\n";
+
+	// The selector normalises each window itself, so the panel keeps raw prices
+	const PricePanel panel = PricePanel::build(universe.survivors, universe.survivorStocks, calendar, priceField, start, end);
+	const std::vector<WalkForwardSelector::Rebalance> rebalances = WalkForwardSelector::run(panel, windowLength, rebalanceInterval);
+
+	std::ofstream outFile(pairingsFile);
+	if (!outFile.is_open()) {
+		std::cerr << "Error: Unable to open file " << pairingsFile << "\n";
+		return 0;
+	}
+	outFile << "Formation Start,Formation End,Stock1,Stock2,Spread Standard Deviation\n";
+
+	std::size_t rowsWritten = 0;
+	for (const WalkForwardSelector::Rebalance& rebalance : rebalances) {
+		const std::string rowPrefix = panel.getSessions()[rebalance.firstSession].toString() + "," + rebalance.date.toString() + ",";
+		for (const GreedyPairing::Pair& pair : rebalance.pairs) {
+			outFile << rowPrefix << panel.getSymbol(pair.base) << "," << panel.getSymbol(pair.partner) << "," << pair.score << "\n";
+			rowsWritten++;
+		}
+	}
+	std::cout << "Paired " << panel.symbolCount() << " listings at " << rebalances.size() << " rebalance dates\n";
+	return rowsWritten;
+}
@@ -0,0 +1,102 @@
+#include "MappedFile.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MAPPEDFILE_USE_MMAP 1
+#endif
+
+MappedFile::MappedFile(const std::string& filename) {
+    open(filename);
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        fallbackBuffer = std::move(other.fallbackBuffer);
+        mappedData = other.mapped ? other.mappedData : fallbackBuffer.data();
+        mappedSize = other.mappedSize;
+        opened = other.opened;
+        mapped = other.mapped;
+        other.mappedData = nullptr;
+        other.mappedSize = 0;
+        other.opened = false;
+        other.mapped = false;
+    }
+    return *this;
+}
+
+// Map a file into memory
+bool MappedFile::open(const std::string& filename) {
+    close();
+
+#ifdef MAPPEDFILE_USE_MMAP
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    mappedSize = static_cast<std::size_t>(info.st_size);
+    if (mappedSize > 0) {
+        void* region = ::mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (region == MAP_FAILED) {
+            ::close(fd);
+            mappedSize = 0;
+            return false;
+        }
+        // The loaders scan front to back exactly once
+        ::madvise(region, mappedSize, MADV_SEQUENTIAL);
+        mappedData = static_cast<const char*>(region);
+        mapped = true;
+    }
+    ::close(fd); // The mapping stays valid after the descriptor is closed
+#else
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return false;
+
+    mappedSize = static_cast<std::size_t>(file.tellg());
+    fallbackBuffer.resize(mappedSize);
+    file.seekg(0);
+    if (mappedSize > 0 && !file.read(fallbackBuffer.data(), static_cast<std::streamsize>(mappedSize))) {
+        fallbackBuffer.clear();
+        mappedSize = 0;
+        return false;
+    }
+    mappedData = fallbackBuffer.data();
+#endif
+
+    opened = true;
+    return true;
+}
+
+// Release the mapping
+void MappedFile::close() {
+#ifdef MAPPEDFILE_USE_MMAP
+    if (mapped) {
+        ::munmap(const_cast<char*>(mappedData), mappedSize);
+    }
+#endif
+    fallbackBuffer.clear();
+    mappedData = nullptr;
+    mappedSize = 0;
+    opened = false;
+    mapped = false;
+}
+
+bool MappedFile::isOpen() const { return opened; }
+const char* MappedFile::data() const { return mappedData; }
+std::size_t MappedFile::size() const { return mappedSize; }
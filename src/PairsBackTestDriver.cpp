@@ -0,0 +1,388 @@
+#include "PairsBackTestDriver.hpp"
+#include "ResultSink.hpp"
+
+namespace {
+	// Channels of the result sink the outcomes are written through; messages and errors go straight to the console
+	enum SinkChannel { RESULTS_CHANNEL, TRADES_CHANNEL, CHANNEL_COUNT };
+
+	// Helper function to split a pair into its two stock names
+	std::pair<std::string, std::string> splitPair(const std::string& pair) {
+		size_t delimiterPos = pair.find("-");
+		return {pair.substr(0, delimiterPos), pair.substr(delimiterPos + 1)};
+	}
+
+	// Helper function to add the window dates leading every columnar row; all are parsed before any is added, so a
+	// bad date leaves no partial row
+	void addWindow(ColumnarTable::Writer& out, const PairsBackTestDriver::Window& window) {
+		const Date dates[4] = {Date::parse(window.formationStart), Date::parse(window.formationEnd),
+			Date::parse(window.tradingStart), Date::parse(window.tradingEnd)};
+		for (const Date& date : dates) out.addDate(date);
+	}
+}
+
+const std::string PairsBackTestDriver::RESULT_HEADER =
+	"Pair,Mean,Standard Deviation,P-value,ADF P-value AIC,ADF P-value BIC,PP Short Rho,PP Long Rho,PP Short Tau,PP Long Tau,KPSS Short,KPSS Long,"
+	"Rate Return,Trade Count,Max Drawdown,Sharpe Ratio";
+
+const std::vector<ColumnarTable::Column> PairsBackTestDriver::RESULT_COLUMNS = {
+	{"Formation Start", ColumnarTable::ColumnType::Date},
+	{"Formation End", ColumnarTable::ColumnType::Date},
+	{"Trading Start", ColumnarTable::ColumnType::Date},
+	{"Trading End", ColumnarTable::ColumnType::Date},
+	{"Stock 1", ColumnarTable::ColumnType::String},
+	{"Stock 2", ColumnarTable::ColumnType::String},
+	{"Mean", ColumnarTable::ColumnType::Float64},
+	{"Standard Deviation", ColumnarTable::ColumnType::Float64},
+	{"P-value", ColumnarTable::ColumnType::Float64},
+	{"ADF P-value AIC", ColumnarTable::ColumnType::Float64},
+	{"ADF P-value BIC", ColumnarTable::ColumnType::Float64},
+	{"PP Short Rho", ColumnarTable::ColumnType::Float64},
+	{"PP Long Rho", ColumnarTable::ColumnType::Float64},
+	{"PP Short Tau", ColumnarTable::ColumnType::Float64},
+	{"PP Long Tau", ColumnarTable::ColumnType::Float64},
+	{"KPSS Short", ColumnarTable::ColumnType::Float64},
+	{"KPSS Long", ColumnarTable::ColumnType::Float64},
+	{"Rate Return", ColumnarTable::ColumnType::Float64},
+	{"Trade Count", ColumnarTable::ColumnType::Int64},
+	{"Max Drawdown", ColumnarTable::ColumnType::Float64},
+	{"Sharpe Ratio", ColumnarTable::ColumnType::Float64}
+};
+
+const std::vector<ColumnarTable::Column> PairsBackTestDriver::TRADE_COLUMNS = {
+	{"Formation Start", ColumnarTable::ColumnType::Date},
+	{"Formation End", ColumnarTable::ColumnType::Date},
+	{"Trading Start", ColumnarTable::ColumnType::Date},
+	{"Trading End", ColumnarTable::ColumnType::Date},
+	{"Stock 1", ColumnarTable::ColumnType::String},
+	{"Stock 2", ColumnarTable::ColumnType::String},
+	{"Entry Date", ColumnarTable::ColumnType::Date},
+	{"Exit Date", ColumnarTable::ColumnType::Date},
+	{"Stock 1 Entry Price", ColumnarTable::ColumnType::Float64},
+	{"Stock 1 Exit Price", ColumnarTable::ColumnType::Float64},
+	{"Stock 2 Entry Price", ColumnarTable::ColumnType::Float64},
+	{"Stock 2 Exit Price", ColumnarTable::ColumnType::Float64},
+	{"Profit Loss", ColumnarTable::ColumnType::Float64}
+};
+
+// Policy setting the thresholds to multiples of the formation spread standard deviation
+PairsBackTestDriver::ConfigPolicy PairsBackTestDriver::thresholdPolicy(
+	double entryMultiplier, double exitMultiplier, double tradeAmount, double slippage) {
+	return [=](const std::string&, const PairsTradingBackTesting::PairStatistics& stats) {
+		PairsTradingBackTesting::BackTestingConfig config;
+		config.entryThreshold = entryMultiplier * stats.standardDeviation;
+		config.exitThreshold = exitMultiplier * stats.standardDeviation;
+		config.tradeAmount = tradeAmount;
+		config.slippage = slippage;
+		return config;
+	};
+}
+
+// Grid of threshold policies, entry-major
+PairsBackTestDriver::GridPolicy PairsBackTestDriver::thresholdGrid(const std::vector<double>& entryMultipliers,
+	const std::vector<double>& exitMultipliers, double tradeAmount, double slippage) {
+	return [=](const std::string& pair, const PairsTradingBackTesting::PairStatistics& stats) {
+		std::vector<PairsTradingBackTesting::BackTestingConfig> configs;
+		configs.reserve(entryMultipliers.size() * exitMultipliers.size());
+		for (double entryMultiplier : entryMultipliers) {
+			for (double exitMultiplier : exitMultipliers) {
+				configs.push_back(thresholdPolicy(entryMultiplier, exitMultiplier, tradeAmount, slippage)(pair, stats));
+			}
+		}
+		return configs;
+	};
+}
+
+// Build the calendar and symbol table shared by the back-tests of a window
+PairsBackTestDriver::SharedTables PairsBackTestDriver::buildSharedTables(
+	const std::map<std::string, PairsTradingBackTesting::PairStatistics>& pairs, const Window& window,
+	const Settings& settings) {
+	auto symbols = std::make_shared<SymbolTable>();
+	std::vector<Date> sessions;
+	const Date tradingStart = Date::parse(window.tradingStart), tradingEnd = Date::parse(window.tradingEnd);
+	for (const auto& entry : pairs) {
+		const auto [stock1Name, stock2Name] = splitPair(entry.first);
+		for (const std::string& name : {stock1Name, stock2Name}) {
+			const std::size_t known = symbols->size();
+			symbols->intern(name);
+			if (symbols->size() == known) continue;
+
+			// Every date the leg has in the trading period, merged in below
+			std::shared_ptr<const Stock> stock = StockDataStore::instance().get(settings.stockDataDir, name, settings.fileExtension);
+			if (!stock) continue;
+			auto [first, last] = stock->getRange(tradingStart, tradingEnd);
+			sessions.insert(sessions.end(), stock->getDates().begin() + first, stock->getDates().begin() + last);
+		}
+	}
+	std::sort(sessions.begin(), sessions.end());
+	sessions.erase(std::unique(sessions.begin(), sessions.end()), sessions.end());
+	return {std::make_shared<const TradingCalendar>(std::move(sessions)), std::move(symbols)};
+}
+
+// Set up the back-test of one selected pair over the trading period of a window
+PairsTradingBackTesting PairsBackTestDriver::prepareBackTest(const std::string& pair, const Window& window,
+	const Settings& settings, const SharedTables& tables) {
+	const auto [stock1Name, stock2Name] = splitPair(pair);
+
+	// Both legs were loaded during selection and are served from the shared store
+	std::shared_ptr<const Stock> loadedStock1 = StockDataStore::instance().get(settings.stockDataDir, stock1Name, settings.fileExtension);
+	std::shared_ptr<const Stock> loadedStock2 = StockDataStore::instance().get(settings.stockDataDir, stock2Name, settings.fileExtension);
+	if (!loadedStock1 || !loadedStock2) {
+		throw std::runtime_error("Could not load the data of both stocks.");
+	}
+	const Stock& stock1 = *loadedStock1;
+	const Stock& stock2 = *loadedStock2;
+
+	auto stock1Data = StockUtils::getPriceDataInRange(stock1, settings.priceType, window.tradingStart, window.tradingEnd);
+	auto stock2Data = StockUtils::getPriceDataInRange(stock2, settings.priceType, window.tradingStart, window.tradingEnd);
+
+	auto pairSelectionData1 = StockUtils::getPriceDataInRange(stock1, settings.priceType, window.formationStart, window.formationEnd);
+	auto pairSelectionData2 = StockUtils::getPriceDataInRange(stock2, settings.priceType, window.formationStart, window.formationEnd);
+
+	return PairsTradingBackTesting(stock1Name, stock1Data, stock2Name, stock2Data, pairSelectionData1, pairSelectionData2,
+		settings.initialBalance, tables.calendar, tables.symbols);
+}
+
+// Back-test one pair into its outcome
+void PairsBackTestDriver::runPair(PairOutcome& outcome, const Window& window, const Settings& settings,
+	const ConfigPolicy& policy, const SharedTables& tables) {
+	// Messages are kept with the pair and printed when it is written
+	std::ostringstream messages;
+	try {
+		PairsTradingBackTesting backTesting = prepareBackTest(outcome.pair, window, settings, tables);
+		backTesting.setMessageStream(messages);
+		backTesting.run(policy(outcome.pair, outcome.stats));
+		outcome.messages = messages.str();
+
+		outcome.summary.rateReturn = 100.0 / backTesting.getInitialBalance() * (backTesting.getCurrentBalance() - backTesting.getInitialBalance()); // Convert to %
+		outcome.summary.tradeCount = backTesting.getTradeCount();
+		outcome.summary.maxDrawdown = backTesting.calculateMaximumDrawdown();
+		outcome.summary.sharpeRatio = backTesting.calculateSharpeRatio();
+
+		// Keep only the plain trade rows; the back-test and its price maps are released here
+		outcome.legNames = backTesting.getLegNames();
+		outcome.trades.reserve(backTesting.getTrades().size());
+		for (const BackTesting::Trade& trade : backTesting.getTrades()) {
+			outcome.trades.push_back(backTesting.resolveTrade(trade));
+		}
+		outcome.succeeded = true;
+	} catch (const std::exception& e) {
+		outcome.messages = messages.str();
+		outcome.error = e.what();
+	}
+}
+
+// Back-test every pair concurrently
+std::vector<PairsBackTestDriver::PairOutcome> PairsBackTestDriver::run(
+	const std::map<std::string, PairsTradingBackTesting::PairStatistics>& pairs,
+	const Window& window, const Settings& settings, const ConfigPolicy& policy) {
+	// One slot per pair, in map order; each task writes only its own
+	std::vector<PairOutcome> outcomes(pairs.size());
+	std::size_t index = 0;
+	for (const auto& [pair, stats] : pairs) {
+		outcomes[index].pair = pair;
+		outcomes[index].stats = stats;
+		index++;
+	}
+
+	const SharedTables tables = buildSharedTables(pairs, window, settings);
+	ThreadPool threadPool(settings.threadCount);
+	threadPool.parallelFor(outcomes.size(), [&](std::size_t i, unsigned int) {
+		runPair(outcomes[i], window, settings, policy, tables);
+	});
+
+	return outcomes;
+}
+
+// Sweep every pair over its grid concurrently
+std::vector<PairsBackTestDriver::PairSweep> PairsBackTestDriver::sweep(
+	const std::map<std::string, PairsTradingBackTesting::PairStatistics>& pairs,
+	const Window& window, const Settings& settings, const GridPolicy& grid) {
+	std::vector<PairSweep> sweeps(pairs.size());
+	std::vector<const PairsTradingBackTesting::PairStatistics*> stats(pairs.size());
+	std::size_t index = 0;
+	for (const auto& [pair, pairStats] : pairs) {
+		sweeps[index].pair = pair;
+		stats[index] = &pairStats;
+		index++;
+	}
+
+	const SharedTables tables = buildSharedTables(pairs, window, settings);
+	ThreadPool threadPool(settings.threadCount);
+	threadPool.parallelFor(sweeps.size(), [&](std::size_t i, unsigned int) {
+		PairSweep& pairSweep = sweeps[i];
+		try {
+			pairSweep.configs = grid(pairSweep.pair, *stats[i]);
+			pairSweep.summaries = prepareBackTest(pairSweep.pair, window, settings, tables).sweep(pairSweep.configs);
+			pairSweep.succeeded = true;
+		} catch (const std::exception& e) {
+			pairSweep.error = e.what();
+		}
+	});
+
+	return sweeps;
+}
+
+// Write the statistics and summary metrics of one pair
+void PairsBackTestDriver::writeResultRow(TextBuffer& out, const PairOutcome& outcome) {
+	const PairsTradingBackTesting::PairStatistics& stats = outcome.stats;
+	out << outcome.pair << ","
+	   << stats.mean << ","
+	   << stats.standardDeviation << ","
+	   << stats.pValue << ","
+	   << stats.adfPValueAIC << ","
+	   << stats.adfPValueBIC << ","
+	   << stats.ppPValueShortRho << ","
+	   << stats.ppPValueLongRho << ","
+	   << stats.ppPValueShortTau << ","
+	   << stats.ppPValueLongTau << ","
+	   << stats.kpssPValueShort << ","
+	   << stats.kpssPValueLong << ","
+	   << outcome.summary.rateReturn << ","
+	   << outcome.summary.tradeCount << ","
+	   << outcome.summary.maxDrawdown << ","
+	   << outcome.summary.sharpeRatio << '\n';
+}
+
+// Write the block of one pair's trades
+void PairsBackTestDriver::writeTrades(TextBuffer& out, const PairOutcome& outcome) {
+	out << outcome.pair << '\n';
+	for (const BackTesting::TradeRow& trade : outcome.trades) {
+		BackTesting::writeTradeRow(out, trade);
+	}
+	out << '\n';
+}
+
+// Add the statistics and summary metrics of one pair to a columnar table
+void PairsBackTestDriver::addResultRow(ColumnarTable::Writer& out, const Window& window, const PairOutcome& outcome) {
+	const PairsTradingBackTesting::PairStatistics& stats = outcome.stats;
+	const auto [stock1Name, stock2Name] = splitPair(outcome.pair);
+	addWindow(out, window);
+	out.addString(stock1Name);
+	out.addString(stock2Name);
+	out.addDouble(stats.mean);
+	out.addDouble(stats.standardDeviation);
+	out.addDouble(stats.pValue);
+	out.addDouble(stats.adfPValueAIC);
+	out.addDouble(stats.adfPValueBIC);
+	out.addDouble(stats.ppPValueShortRho);
+	out.addDouble(stats.ppPValueLongRho);
+	out.addDouble(stats.ppPValueShortTau);
+	out.addDouble(stats.ppPValueLongTau);
+	out.addDouble(stats.kpssPValueShort);
+	out.addDouble(stats.kpssPValueLong);
+	out.addDouble(outcome.summary.rateReturn);
+	out.addInteger(outcome.summary.tradeCount);
+	out.addDouble(outcome.summary.maxDrawdown);
+	out.addDouble(outcome.summary.sharpeRatio);
+	out.endRow();
+}
+
+// Add one row per trade of an outcome to a columnar table
+void PairsBackTestDriver::addTradeRows(ColumnarTable::Writer& out, const Window& window, const PairOutcome& outcome) {
+	for (const BackTesting::TradeRow& trade : outcome.trades) {
+		addWindow(out, window);
+		out.addString(outcome.legNames[0]);
+		out.addString(outcome.legNames[1]);
+		out.addDate(trade.entryDate);
+		out.addDate(trade.exitDate);
+		for (std::size_t leg = 0; leg < BackTesting::LEG_COUNT; ++leg) {
+			out.addDouble(trade.entryPrices[leg]);
+			out.addDouble(trade.exitPrices[leg]);
+		}
+		out.addDouble(trade.profitLoss);
+		out.endRow();
+	}
+}
+
+// Format the text of one outcome for the result sink
+ResultSink::Record PairsBackTestDriver::formatOutcome(const PairOutcome& outcome, std::uint64_t sequence,
+	const std::string& rowPrefix, bool& tradesHeaderWritten, const ColumnarOutput* columnar) {
+	ResultSink::Record record;
+	record.sequence = sequence;
+	record.chunks.resize(CHANNEL_COUNT);
+	if (!outcome.succeeded) {
+		record.finalize = [messages = outcome.messages, pair = outcome.pair, error = outcome.error](std::vector<std::string>&) {
+			std::cout << messages;
+			std::cerr << "Error processing pair " << pair << ": " << error << "\n";
+		};
+		return record;
+	}
+
+	TextBuffer row;
+	row << rowPrefix;
+	writeResultRow(row, outcome);
+	record.chunks[RESULTS_CHANNEL] = std::move(row.str());
+
+	TextBuffer trades;
+	writeTrades(trades, outcome);
+	record.chunks[TRADES_CHANNEL] = std::move(trades.str());
+
+	// Which pair writes the trades header is only known in pair order, on the writer thread
+	TextBuffer header;
+	BackTesting::writeTradeHeader(header, outcome.legNames);
+
+	// The columnar rows are added in pair order too, from a copy of the outcome's statistics and plain trade rows
+	PairOutcome columnarOutcome;
+	if (columnar) {
+		columnarOutcome.pair = outcome.pair;
+		columnarOutcome.stats = outcome.stats;
+		columnarOutcome.summary = outcome.summary;
+		columnarOutcome.legNames = outcome.legNames;
+		columnarOutcome.trades = outcome.trades;
+	}
+	record.finalize = [&tradesHeaderWritten, header = std::move(header.str()), columnar,
+		messages = outcome.messages, columnarOutcome = std::move(columnarOutcome)](std::vector<std::string>& chunks) {
+		std::cout << messages;
+		if (columnar) {
+			try {
+				if (columnar->results) addResultRow(*columnar->results, columnar->window, columnarOutcome);
+				if (columnar->trades) addTradeRows(*columnar->trades, columnar->window, columnarOutcome);
+			} catch (const std::exception& e) {
+				std::cerr << "Error writing columnar rows of pair " << columnarOutcome.pair << ": " << e.what() << "\n";
+			}
+		}
+
+		if (tradesHeaderWritten) return;
+		tradesHeaderWritten = true;
+		chunks[TRADES_CHANNEL].insert(0, header);
+	};
+	return record;
+}
+
+// Write the outcomes in pair order
+std::size_t PairsBackTestDriver::write(const std::vector<PairOutcome>& outcomes, std::ostream& results,
+	std::ostream& trades, bool& tradesHeaderWritten, const std::string& rowPrefix, const ColumnarOutput* columnar) {
+	ResultSink sink({&results, &trades});
+	std::size_t rowsWritten = 0;
+	for (std::size_t i = 0; i < outcomes.size(); ++i) {
+		sink.submit(formatOutcome(outcomes[i], i, rowPrefix, tradesHeaderWritten, columnar));
+		if (outcomes[i].succeeded) rowsWritten++;
+	}
+	sink.close();
+	return rowsWritten;
+}
+
+// Back-test every pair concurrently, writing each as soon as the pairs before it are written
+std::size_t PairsBackTestDriver::runAndWrite(const std::map<std::string, PairsTradingBackTesting::PairStatistics>& pairs,
+	const Window& window, const Settings& settings, const ConfigPolicy& policy, std::ostream& results,
+	std::ostream& trades, bool& tradesHeaderWritten, const std::string& rowPrefix, const ColumnarOutput* columnar) {
+	std::vector<std::pair<const std::string*, const PairsTradingBackTesting::PairStatistics*>> items;
+	items.reserve(pairs.size());
+	for (const auto& [pair, stats] : pairs) items.emplace_back(&pair, &stats);
+
+	const SharedTables tables = buildSharedTables(pairs, window, settings);
+	ResultSink sink({&results, &trades});
+	std::atomic<std::size_t> rowsWritten{0};
+	ThreadPool threadPool(settings.threadCount);
+	threadPool.parallelFor(items.size(), [&](std::size_t i, unsigned int) {
+		// The outcome, trades included, is released once formatted
+		PairOutcome outcome;
+		outcome.pair = *items[i].first;
+		outcome.stats = *items[i].second;
+		runPair(outcome, window, settings, policy, tables);
+		if (outcome.succeeded) rowsWritten++;
+		sink.submit(formatOutcome(outcome, i, rowPrefix, tradesHeaderWritten, columnar));
+	});
+	sink.close();
+	return rowsWritten.load();
+}
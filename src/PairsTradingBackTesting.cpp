@@ -1,6 +1,90 @@
 #include "PairsTradingBackTesting.hpp"
 #include <chrono>
 
+namespace {
+    // Stands in for files that could not be loaded, so the checks below fail the way they do for empty data
+    const Stock EMPTY_STOCK;
+
+    // Candidates per work item when the spread kernel is spread over the pool; a multiple of the kernel's block of four
+    const std::size_t SCORING_CHUNK_SIZE = 256;
+
+    // Listings screened between two flushes to the row sink; bounds the results held at any time
+    const std::size_t BENCHMARK_SCREEN_BLOCK_SIZE = 1024;
+
+    // Listings per work item of the batched benchmark regression
+    const std::size_t BENCHMARK_REGRESSION_CHUNK_SIZE = 64;
+
+    // Helper running normalise, difference to the benchmark, log and the index regression of one listing in a single
+    // pass. Missing values are skipped; failures throw with the messages of the StockAnalysis steps this replaces
+    StatisticalAnalysis::LinearRegressionResult regressLogDifferences(
+        SeriesView rows, SeriesView normalizedBenchmark, std::size_t& count, double& lastDifference
+    ) {
+        std::size_t first = 0;
+        while (first < rows.size() && std::isnan(rows.valueAt(first))) first++;
+        if (first == rows.size()) {
+            throw std::invalid_argument("Data dictionary is empty.");
+        }
+        const double baseValue = rows.valueAt(first);
+        if (baseValue == 0) {
+            throw std::runtime_error("The price value on the earliest date is zero, cannot normalize.");
+        }
+
+        StatisticalAnalysis::IndexRegressionAccumulator accumulator;
+        std::size_t j = 0;
+        for (std::size_t i = first; i < rows.size(); ++i) {
+            const double value = rows.valueAt(i);
+            if (std::isnan(value)) continue;
+
+            // Both axes are sorted, so a single forward walk over the benchmark finds every date
+            const Date date = rows.dateAt(i);
+            while (j < normalizedBenchmark.size() && normalizedBenchmark.dateAt(j) < date) j++;
+            if (j == normalizedBenchmark.size() || normalizedBenchmark.dateAt(j) != date) {
+                throw std::invalid_argument("Data dictionaries do not have identical dates.");
+            }
+
+            // Invalid logs count as 0, as in StockAnalysis::applyMapOperation
+            const double difference = value / baseValue - normalizedBenchmark.valueAt(j);
+            double logDifference = std::log(difference);
+            if (std::isnan(logDifference) || std::isinf(logDifference)) {
+                logDifference = 0.0;
+            }
+            accumulator.add(logDifference);
+            lastDifference = difference;
+        }
+
+        count = accumulator.count();
+        return accumulator.result();
+    }
+
+    // Helper writing the log differences of a listing with a value on every benchmark session into column, whose
+    // chronological index is then the shared x of the batched regression. Returns false for a listing with gaps,
+    // which is left to regressLogDifferences
+    bool writeCompleteLogDifferences(
+        SeriesView rows, SeriesView normalizedBenchmark, Eigen::Ref<Eigen::VectorXd> column, double& lastDifference
+    ) {
+        if (rows.size() == 0 || rows.size() != normalizedBenchmark.size() || std::isnan(rows.valueAt(0))) return false;
+        const double baseValue = rows.valueAt(0);
+        if (baseValue == 0) {
+            throw std::runtime_error("The price value on the earliest date is zero, cannot normalize.");
+        }
+
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            const double value = rows.valueAt(i);
+            if (std::isnan(value) || rows.dateAt(i) != normalizedBenchmark.dateAt(i)) return false;
+
+            // Invalid logs count as 0, as in regressLogDifferences
+            const double difference = value / baseValue - normalizedBenchmark.valueAt(i);
+            double logDifference = std::log(difference);
+            if (std::isnan(logDifference) || std::isinf(logDifference)) {
+                logDifference = 0.0;
+            }
+            column[static_cast<Eigen::Index>(i)] = logDifference;
+            lastDifference = difference;
+        }
+        return true;
+    }
+}
+
 // Constructor
 PairsTradingBackTesting::PairsTradingBackTesting(
     const std::string& stock1Name,
@@ -10,6 +94,20 @@ PairsTradingBackTesting::PairsTradingBackTesting(
     const std::unordered_map<std::string, double>& pairSelectionData1,
     const std::unordered_map<std::string, double>& pairSelectionData2,
     double initialBalance)
+    : PairsTradingBackTesting(stock1Name, stock1Data, stock2Name, stock2Data, pairSelectionData1, pairSelectionData2,
+          initialBalance, nullptr, nullptr) {}
+
+// Constructor with shared tables
+PairsTradingBackTesting::PairsTradingBackTesting(
+    const std::string& stock1Name,
+    const std::unordered_map<std::string, double>& stock1Data,
+    const std::string& stock2Name,
+    const std::unordered_map<std::string, double>& stock2Data,
+    const std::unordered_map<std::string, double>& pairSelectionData1,
+    const std::unordered_map<std::string, double>& pairSelectionData2,
+    double initialBalance,
+    std::shared_ptr<const TradingCalendar> sharedCalendar,
+    std::shared_ptr<const SymbolTable> sharedSymbols)
     : BackTesting(initialBalance),
       stock1Name(stock1Name),
       stock2Name(stock2Name),
@@ -18,8 +116,43 @@ PairsTradingBackTesting::PairsTradingBackTesting(
       pairSelectionData1(pairSelectionData1),
       pairSelectionData2(pairSelectionData2) {
 
-    normalizedStock1Data = StockAnalysis::normalizeToReferenceData(stock1Data, pairSelectionData1);
-    normalizedStock2Data = StockAnalysis::normalizeToReferenceData(stock2Data, pairSelectionData2);
+    // Sort each leg once; the sorted raw series also feed the vectorised engine
+    Series reference, normalized;
+    StockUtils::toSeries(stock1Data, stock1Series);
+    StockUtils::toSeries(pairSelectionData1, reference);
+    normalizedStock1Data = StockUtils::toMap(StockAnalysis::normalizeToReferenceData(stock1Series, reference, normalized));
+    stock1ReferenceBase = reference.getValues().front();
+
+    StockUtils::toSeries(stock2Data, stock2Series);
+    StockUtils::toSeries(pairSelectionData2, reference);
+    normalizedStock2Data = StockUtils::toMap(StockAnalysis::normalizeToReferenceData(stock2Series, reference, normalized));
+    stock2ReferenceBase = reference.getValues().front();
+
+    // Trades refer to sessions of the calendar and to the legs by id; on its own, the pair gets the sessions of stock1
+    if (!sharedCalendar) {
+        sharedCalendar = std::make_shared<const TradingCalendar>(stock1Series.getDates());
+    }
+    if (!sharedSymbols) {
+        auto pairSymbols = std::make_shared<SymbolTable>();
+        pairSymbols->intern(stock1Name);
+        pairSymbols->intern(stock2Name);
+        sharedSymbols = std::move(pairSymbols);
+    }
+    calendar = std::move(sharedCalendar);
+    symbols = std::move(sharedSymbols);
+    for (const Date& date : stock1Series.getDates()) {
+        if (!calendar->isSession(date)) {
+            throw std::out_of_range("The trading calendar lacks the session " + date.toString() + " of " + stock1Name + ".");
+        }
+    }
+    stock1Symbol = symbols->id(stock1Name);
+    stock2Symbol = symbols->id(stock2Name);
+    legs = {stock1Symbol, stock2Symbol};
+}
+
+// Map a position in stock1Series to its calendar session
+std::uint32_t PairsTradingBackTesting::calendarSession(std::size_t stock1Position) const {
+    return static_cast<std::uint32_t>(calendar->sessionIndex(stock1Series.getDates()[stock1Position]));
 }
 
 // Calculate spread between normalized prices
@@ -44,48 +177,218 @@ bool PairsTradingBackTesting::isExitSignal(double spread, double threshold) cons
 
 // Run back-test
 void PairsTradingBackTesting::run(const BackTestingConfig& config) {
+    if (config.engine == BackTestEngine::Legacy) {
+        runLegacy(config);
+    } else {
+        runVectorised(config);
+    }
+}
+
+// Align both legs on the sessions of stock1 that stock2 also has
+PairsTradingBackTesting::AlignedLegs PairsTradingBackTesting::alignLegs() const {
+    // Both series are sorted by date
+    AlignedLegs legs;
+    legs.sessions.reserve(stock1Series.size());
+    Eigen::ArrayXd prices1(static_cast<Eigen::Index>(stock1Series.size()));
+    Eigen::ArrayXd prices2(static_cast<Eigen::Index>(stock1Series.size()));
+    Eigen::Index aligned = 0;
+    std::size_t j = 0;
+    for (std::size_t i = 0; i < stock1Series.size(); ++i) {
+        const Date date = stock1Series.getDates()[i];
+        while (j < stock2Series.size() && stock2Series.getDates()[j] < date) j++;
+        if (j == stock2Series.size() || stock2Series.getDates()[j] != date) continue;
+        legs.sessions.push_back(static_cast<std::uint32_t>(i));
+        prices1[aligned] = stock1Series.getValues()[i];
+        prices2[aligned] = stock2Series.getValues()[j];
+        aligned++;
+    }
+    legs.prices1 = prices1.head(aligned);
+    legs.prices2 = prices2.head(aligned);
+
+    // Normalized prices and absolute spreads of every aligned session in one vectorised pass
+    legs.normalized1 = legs.prices1 / stock1ReferenceBase;
+    legs.normalized2 = legs.prices2 / stock2ReferenceBase;
+    legs.absoluteSpreads = (legs.normalized1 - legs.normalized2).abs();
+    return legs;
+}
+
+// Run back-test over aligned arrays
+void PairsTradingBackTesting::runVectorised(const BackTestingConfig& config) {
+    const AlignedLegs legs = alignLegs();
+    const Eigen::ArrayXd& prices1 = legs.prices1;
+    const Eigen::ArrayXd& prices2 = legs.prices2;
+    const Eigen::ArrayXd& normalized1 = legs.normalized1;
+    const Eigen::ArrayXd& normalized2 = legs.normalized2;
+    const Eigen::ArrayXd& absoluteSpreads = legs.absoluteSpreads;
+    const Eigen::Index aligned = absoluteSpreads.size();
+
+    // Entry/exit state machine over the aligned sessions; a trade spans two sessions, except one left open at the last
+    trades.reserve(trades.size() + static_cast<std::size_t>(aligned) / 2 + 1);
+    if (config.keepEquityCurve) metrics.keepEquityCurve(static_cast<std::size_t>(aligned));
+    const double requiredBalance = config.tradeAmount * 2;
+    Eigen::Index entry = -1;
+    auto recordAlignedTrade = [&](std::uint32_t exitSession, double exitPrice1, double exitPrice2) {
+        double profitLoss = calculateProfitLoss(prices1[entry], prices2[entry], exitPrice1, exitPrice2,
+            normalized1[entry], normalized2[entry], config.tradeAmount);
+
+        currentBalance += config.tradeAmount * 2 + profitLoss;
+
+        Trade trade{calendarSession(legs.sessions[static_cast<std::size_t>(entry)]), exitSession, {stock1Symbol, stock2Symbol},
+            {prices1[entry], prices2[entry]}, {exitPrice1, exitPrice2}, profitLoss};
+        recordTrade(trade);
+    };
+
+    for (Eigen::Index k = 0; k < aligned; ++k) {
+        if (entry < 0) {
+            if (currentBalance >= requiredBalance && absoluteSpreads[k] > config.entryThreshold) {
+                entry = k;
+                currentBalance -= requiredBalance;
+            }
+        } else if (absoluteSpreads[k] < config.exitThreshold) {
+            recordAlignedTrade(calendarSession(legs.sessions[static_cast<std::size_t>(k)]), prices1[k], prices2[k]);
+            entry = -1;
+        }
+
+        // A trade still open on the last session of stock1 is closed below, and that session's bar added after it
+        if (entry >= 0 && legs.sessions[static_cast<std::size_t>(k)] + 1 == stock1Series.size()) break;
+
+        // Mark the open trade to market at the session's prices
+        double openProfitLoss = entry < 0 ? 0.0 : calculateProfitLoss(prices1[entry], prices2[entry], prices1[k], prices2[k],
+            normalized1[entry], normalized2[entry], config.tradeAmount);
+        metrics.addBar(metrics.getRealisedBalance() + openProfitLoss);
+    }
+
+    // Close any open trades at the last date of stock1
+    if (entry >= 0) {
+        const std::string lastDate = stock1Series.getDates().back().toString();
+        double price1 = stock1Series.getValues().back();
+        double price2 = stock2Data.at(lastDate);
+
+        *messageStream << "Closing open trade at end date: " << lastDate << "\n";
+
+        recordAlignedTrade(calendarSession(stock1Series.size() - 1), price1, price2);
+        metrics.addBar(metrics.getRealisedBalance());
+    }
+}
+
+// Evaluate many configurations in one pass over the aligned sessions
+std::vector<PairsTradingBackTesting::BackTestSummary> PairsTradingBackTesting::sweep(
+    const std::vector<BackTestingConfig>& configs) const {
+    const AlignedLegs legs = alignLegs();
+    const Eigen::Index aligned = legs.absoluteSpreads.size();
+    const std::size_t configCount = configs.size();
+
+    // State of every configuration as one array per field, so each session streams over contiguous values
+    std::vector<double> entryThresholds(configCount), exitThresholds(configCount), tradeAmounts(configCount);
+    std::vector<double> requiredBalances(configCount), balances(configCount, initialBalance);
+    std::vector<Eigen::Index> entries(configCount, -1);
+    for (std::size_t c = 0; c < configCount; ++c) {
+        entryThresholds[c] = configs[c].entryThreshold;
+        exitThresholds[c] = configs[c].exitThreshold;
+        tradeAmounts[c] = configs[c].tradeAmount;
+        requiredBalances[c] = configs[c].tradeAmount * 2;
+    }
+
+    // Per-trade metrics, touched only when a trade closes
+    std::vector<PerformanceMetrics> tradeMetrics(configCount, PerformanceMetrics(initialBalance));
+
+    // Close the open trade of configuration c, with the balance updates of run(config) and recordTrade
+    auto closeTrade = [&](std::size_t c, double exitPrice1, double exitPrice2) {
+        const Eigen::Index entry = entries[c];
+        double profitLoss = calculateProfitLoss(legs.prices1[entry], legs.prices2[entry], exitPrice1, exitPrice2,
+            legs.normalized1[entry], legs.normalized2[entry], tradeAmounts[c]);
+        balances[c] += tradeAmounts[c] * 2 + profitLoss;
+        balances[c] += profitLoss;
+        tradeMetrics[c].addTrade(profitLoss);
+        entries[c] = -1;
+    };
+
+    for (Eigen::Index k = 0; k < aligned; ++k) {
+        const double absoluteSpread = legs.absoluteSpreads[k];
+        for (std::size_t c = 0; c < configCount; ++c) {
+            if (entries[c] < 0) {
+                if (balances[c] >= requiredBalances[c] && absoluteSpread > entryThresholds[c]) {
+                    entries[c] = k;
+                    balances[c] -= requiredBalances[c];
+                }
+            } else if (absoluteSpread < exitThresholds[c]) {
+                closeTrade(c, legs.prices1[k], legs.prices2[k]);
+            }
+        }
+    }
+
+    // Close the open trades at the last date of stock1, as run(config) does
+    for (std::size_t c = 0; c < configCount; ++c) {
+        if (entries[c] < 0) continue;
+        const std::string lastDate = stock1Series.getDates().back().toString();
+        closeTrade(c, stock1Series.getValues().back(), stock2Data.at(lastDate));
+    }
+
+    std::vector<BackTestSummary> summaries(configCount);
+    for (std::size_t c = 0; c < configCount; ++c) {
+        BackTestSummary& summary = summaries[c];
+        summary.rateReturn = 100.0 / initialBalance * (balances[c] - initialBalance); // Convert to %
+        summary.tradeCount = static_cast<int>(tradeMetrics[c].tradeCount());
+        summary.maxDrawdown = tradeMetrics[c].maxDrawdown();
+        summary.sharpeRatio = tradeMetrics[c].tradeSharpeRatio();
+    }
+    return summaries;
+}
+
+// Run back-test with date-keyed lookups
+void PairsTradingBackTesting::runLegacy(const BackTestingConfig& config) {
     std::string entryDate;
 	std::string exitDate;
-    std::unordered_map<std::string, double> entryPrices;
+    std::uint32_t entryPosition = 0;   // Position of the entry in stock1Series
+    std::array<double, LEG_COUNT> entryPrices{};
+    std::array<double, LEG_COUNT> normalizedEntryPrices{};
 	
-	// sort stock1Data by date
+	// sort stock1Data by date; positions match the sessions of stock1
 	std::vector<std::pair<std::string, double>> stock1DataSorted = StockAnalysis::sortMap(stock1Data);
+    trades.reserve(trades.size() + stock1DataSorted.size() / 2 + 1);
+    if (config.keepEquityCurve) metrics.keepEquityCurve(stock1DataSorted.size());
 	
-    for (const auto& [date, price1] : stock1DataSorted) {
-        if (stock2Data.count(date) == 0) continue;
+    for (std::size_t session = 0; session < stock1DataSorted.size(); ++session) {
+        const auto& [date, price1] = stock1DataSorted[session];
+        auto stock2Price = stock2Data.find(date);
+        if (stock2Price == stock2Data.end()) continue;
+        const double price2 = stock2Price->second;
 
         double spread = calculateSpread(date);
 
         if (entryDate.empty()) {
-            if (currentBalance < config.tradeAmount * 2) {
-                continue;
-            }
-
-            if (fabs(spread) > config.entryThreshold) {
+            if (currentBalance >= config.tradeAmount * 2 && fabs(spread) > config.entryThreshold) {
                 entryDate = date;
-                entryPrices[stock1Name] = price1;
-                entryPrices[stock2Name] = stock2Data.at(date);
+                entryPosition = static_cast<std::uint32_t>(session);
+                entryPrices = {price1, price2};
+                normalizedEntryPrices = {normalizedStock1Data.at(date), normalizedStock2Data.at(date)};
                 currentBalance -= config.tradeAmount * 2;
             }
         } else {
             if (fabs(spread) < config.exitThreshold) {
 				exitDate = date;
-                std::unordered_map<std::string, double> exitPrices;
-                exitPrices[stock1Name] = price1;
-                exitPrices[stock2Name] = stock2Data.at(date);
+                std::array<double, LEG_COUNT> exitPrices = {price1, price2};
 
                 double profitLoss = calculateProfitLoss(entryDate, exitDate, config.tradeAmount);
 
                 currentBalance += config.tradeAmount * 2 + profitLoss;
 
-                Trade trade{entryDate, date, entryPrices, exitPrices, profitLoss};
+                Trade trade{calendarSession(entryPosition), calendarSession(session), {stock1Symbol, stock2Symbol},
+                    entryPrices, exitPrices, profitLoss};
                 recordTrade(trade);
 
                 entryDate.clear();
 				exitDate.clear();
-                entryPrices.clear();
             }
         }
+
+        // A trade still open on the last session is closed below, and that session's bar added after it
+        if (!entryDate.empty() && session + 1 == stock1DataSorted.size()) break;
+
+        // Mark the open trade to market at the session's prices, from the entry's prices rather than date lookups
+        double openProfitLoss = entryDate.empty() ? 0.0 : calculateProfitLoss(entryPrices[0], entryPrices[1], price1, price2,
+            normalizedEntryPrices[0], normalizedEntryPrices[1], config.tradeAmount);
+        metrics.addBar(metrics.getRealisedBalance() + openProfitLoss);
     }
 
     // Close any open trades
@@ -95,18 +398,18 @@ void PairsTradingBackTesting::run(const BackTestingConfig& config) {
 		double price1 = lastEntry.second;
 		double price2 = stock2Data.at(lastEntry.first);
 
-		std::cout << "Closing open trade at end date: " << lastEntry.first << "\n";
+		*messageStream << "Closing open trade at end date: " << lastEntry.first << "\n";
 
-        std::unordered_map<std::string, double> exitPrices;
-        exitPrices[stock1Name] = price1;
-        exitPrices[stock2Name] = price2;
+        std::array<double, LEG_COUNT> exitPrices = {price1, price2};
 		
         double profitLoss = calculateProfitLoss(entryDate, lastDate, config.tradeAmount);
 
         currentBalance += config.tradeAmount * 2 + profitLoss;
 
-        Trade trade{entryDate, lastDate, entryPrices, exitPrices, profitLoss};
+        Trade trade{calendarSession(entryPosition), calendarSession(stock1DataSorted.size() - 1), {stock1Symbol, stock2Symbol},
+            entryPrices, exitPrices, profitLoss};
         recordTrade(trade);
+        metrics.addBar(metrics.getRealisedBalance());
 		
     }
 }
@@ -142,6 +445,15 @@ double PairsTradingBackTesting::calculateProfitLoss(
     double exitPriceStock1 = stock1Data.at(exitDate);
     double exitPriceStock2 = stock2Data.at(exitDate);
 
+    return calculateProfitLoss(entryPriceStock1, entryPriceStock2, exitPriceStock1, exitPriceStock2,
+        normalizedEntryPriceStock1, normalizedEntryPriceStock2, tradeAmount);
+}
+
+// Calculate profit-loss from the prices of a trade
+double PairsTradingBackTesting::calculateProfitLoss(
+    double entryPriceStock1, double entryPriceStock2, double exitPriceStock1, double exitPriceStock2,
+    double normalizedEntryPriceStock1, double normalizedEntryPriceStock2,
+    const double& tradeAmount) {
     double stock1Profit = 0.0, stock2Profit = 0.0;
 
     // Compare normalized prices to decide long/short positions
@@ -158,7 +470,120 @@ double PairsTradingBackTesting::calculateProfitLoss(
     return stock1Profit + stock2Profit;
 }
 
-// Find the appropriate pairs via Distance Method
+// Load and filter the universe of listings in parallel
+PairsTradingBackTesting::UniverseFilterResult PairsTradingBackTesting::filterUniverse(
+    const std::vector<std::string>& stockListings,
+    const std::string& stockDataDir,
+    const std::string& fileExtension,
+    const std::string& priceType,
+    const std::string& startDate,
+    const std::string& endDate,
+    double priceVolumeThreshold,
+    const TradingCalendar& calendar,
+    ThreadPool& threadPool) {
+
+	Stock::Field priceField;
+	if (!Stock::parseField(priceType, priceField)) {
+		throw std::invalid_argument("Unknown price type: " + priceType);
+	}
+	const Date rangeStart = Date::parse(startDate);
+	const Date rangeEnd = Date::parse(endDate);
+
+	// Every listing writes only its own slot, so the merge below is independent of scheduling
+	std::vector<ListingFilterResult> listingResults(stockListings.size());
+	std::vector<std::shared_ptr<const Stock>> stocks(stockListings.size());
+
+	threadPool.parallelFor(stockListings.size(), [&](std::size_t index, unsigned int) {
+		const std::string& nyseListing = stockListings[index];
+		ListingFilterResult& result = listingResults[index];
+		result.symbol = nyseListing;
+
+		// Loading Stock through the shared store, so later stages reuse it
+		std::shared_ptr<const Stock> loadedStock = StockDataStore::instance().get(stockDataDir, nyseListing, fileExtension, &result.loadReport);
+		if (!loadedStock) {
+			result.status = ListingFilterStatus::LoadError;
+			result.reason = "could not open " + stockDataDir + nyseListing + fileExtension;
+			return;
+		}
+		const Stock& stock = *loadedStock;
+
+		try {
+			// Check if Stock is liquid enough
+			double averagePriceVolume = StockAnalysis::calculateAveragePriceVolume(stock, priceType, startDate, endDate);
+			if (averagePriceVolume < priceVolumeThreshold) {
+				result.status = ListingFilterStatus::Illiquid;
+				result.reason = "average price-volume " + std::to_string(averagePriceVolume) + " below threshold";
+				return;
+			}
+		} catch (const std::exception& e) {
+			result.status = ListingFilterStatus::PriceVolumeError;
+			result.reason = e.what();
+			return;
+		}
+
+		// Check if Stock has all valid dates identical to the calendar (SPY) sessions
+		std::string calendarReason;
+		if (!calendar.isAligned(stock, priceField, rangeStart, rangeEnd, &calendarReason)) {
+			result.status = ListingFilterStatus::CalendarMismatch;
+			result.reason = calendarReason;
+			return;
+		}
+
+		// Keep the valid data in memory for the panel
+		stocks[index] = std::move(loadedStock);
+	});
+
+	// Merge in listing order
+	UniverseFilterResult universe;
+	for (std::size_t index = 0; index < stockListings.size(); ++index) {
+		if (listingResults[index].status == ListingFilterStatus::Accepted) {
+			universe.survivors.push_back(stockListings[index]);
+			universe.survivorStocks.push_back(std::move(stocks[index]));
+		}
+	}
+	universe.listingResults = std::move(listingResults);
+	return universe;
+}
+
+// Print the per-listing outcome of filterUniverse
+void PairsTradingBackTesting::printFilterSummary(const UniverseFilterResult& result, const std::string& startDate,
+	const std::string& endDate, std::ostream& os) {
+	std::size_t counts[5] = {};
+	for (const auto& listing : result.listingResults) {
+		counts[static_cast<std::size_t>(listing.status)]++;
+	}
+
+	os << "Universe filter between dates " << startDate << " " << endDate << ": "
+	   << counts[static_cast<std::size_t>(ListingFilterStatus::Accepted)] << " of " << result.listingResults.size() << " listings accepted ("
+	   << counts[static_cast<std::size_t>(ListingFilterStatus::Illiquid)] << " illiquid, "
+	   << counts[static_cast<std::size_t>(ListingFilterStatus::CalendarMismatch)] << " calendar mismatch, "
+	   << counts[static_cast<std::size_t>(ListingFilterStatus::PriceVolumeError)] << " price-volume error, "
+	   << counts[static_cast<std::size_t>(ListingFilterStatus::LoadError)] << " load error)\n";
+
+	for (const auto& listing : result.listingResults) {
+		switch (listing.status) {
+			case ListingFilterStatus::Accepted:
+				break;
+			case ListingFilterStatus::LoadError:
+				os << "  " << listing.symbol << ": load error: " << listing.reason << "\n";
+				break;
+			case ListingFilterStatus::PriceVolumeError:
+				os << "  " << listing.symbol << ": error when checking for price-volume: " << listing.reason << "\n";
+				break;
+			case ListingFilterStatus::Illiquid:
+				os << "  " << listing.symbol << ": not liquid enough: " << listing.reason << "\n";
+				break;
+			case ListingFilterStatus::CalendarMismatch:
+				os << "  " << listing.symbol << ": calendar mismatch: " << listing.reason << "\n";
+				break;
+		}
+		if (listing.loadReport.warningCount() > 0) {
+			FileReader::printLoadReport(listing.symbol, listing.loadReport, os);
+		}
+	}
+}
+
+// Find the appropriate pairs via Distance Method with the default selection settings
 std::map<std::string, PairsTradingBackTesting::PairStatistics> PairsTradingBackTesting::selectPairsForBackTesting(
     std::vector<std::string> stockListings,
     const std::string& stockDataDir,
@@ -167,152 +592,170 @@ std::map<std::string, PairsTradingBackTesting::PairStatistics> PairsTradingBackT
     const std::string& startDate,
     const std::string& endDate,
     double priceVolumeThreshold) {
+	return selectPairsForBackTesting(std::move(stockListings), stockDataDir, fileExtension, priceType,
+		startDate, endDate, priceVolumeThreshold, SelectionConfig());
+}
+
+// Find the appropriate pairs via Distance Method
+std::map<std::string, PairsTradingBackTesting::PairStatistics> PairsTradingBackTesting::selectPairsForBackTesting(
+    std::vector<std::string> stockListings,
+    const std::string& stockDataDir,
+    const std::string& fileExtension,
+    const std::string& priceType,
+    const std::string& startDate,
+    const std::string& endDate,
+    double priceVolumeThreshold,
+    const SelectionConfig& selectionConfig) {
 	auto start = std::chrono::high_resolution_clock::now();
 
 	// Calculate Mean, SDs, P-value, and ADF P-values for all stock pairs
 	
-	// Initialize the dictionary that will hold the pairs as keys and the mean of the difference as the values
-	std::map<std::string, double> stockPairMean, stockPairStandardDeviation;
-
 	// Initlaize pair statistics dictionary for output
     std::map<std::string, PairStatistics> pairStatistics;
 
-	// Initlaize the dictionary that will hold the stock symbol and their object
-	std::unordered_map<std::string, std::unordered_map<std::string, double>> stockAdjClose;
-
 	// Filter out the Stocks that do not have valid dates (i.e. do not have data available within the start and end date) and non-liquid
 	// This step can be done by comparing the stock dates to the SPY stock dates (since it's very hard to know what days the NYSE is open)
-	std::vector<std::string> toRemoveListings;
-	Stock SPY;
-	FileReader::loadStockDataFromFile(stockDataDir + "SPY" + fileExtension, SPY);
-	for(std::string nyseListing : stockListings){
-		// Loading Stock
-		Stock stock;
-		std::cout << "Opening file: " << stockDataDir + nyseListing + fileExtension << "\n";
-		FileReader::loadStockDataFromFile(stockDataDir + nyseListing + fileExtension, stock);
-		
-		try{
-			// Check if Stock is liquid enough
-			if(StockAnalysis::calculateAveragePriceVolume(stock, priceType, startDate, endDate) < priceVolumeThreshold){
-				std::cout << nyseListing << " is not liquid enough in between dates " << startDate << " " << endDate << "\n";
-				toRemoveListings.push_back(nyseListing);
-				continue;
+	std::shared_ptr<const Stock> loadedSPY = StockDataStore::instance().get(stockDataDir, "SPY", fileExtension);
+	const Stock& SPY = loadedSPY ? *loadedSPY : EMPTY_STOCK;
+
+	Stock::Field priceField;
+	if (!Stock::parseField(priceType, priceField)) {
+		throw std::invalid_argument("Unknown price type: " + priceType);
+	}
+	const TradingCalendar calendar = TradingCalendar::fromStock(SPY, priceField);
+
+	ThreadPool threadPool(selectionConfig.threadCount);
+	StageReport stageReport;
+	UniverseFilterResult universe = filterUniverse(stockListings, stockDataDir, fileExtension, priceType,
+		startDate, endDate, priceVolumeThreshold, calendar, threadPool);
+	stageReport.addStage("universe filter", threadPool.getLastRunStatistics());
+	printFilterSummary(universe, startDate, endDate);
+	std::cout << "--------------------------------------------------\n";
+
+	// Build the aligned sessions x symbols panel of the survivors, in listing order, normalized to the first session
+	auto stageStart = std::chrono::steady_clock::now();
+	PricePanel panel = PricePanel::build(universe.survivors, universe.survivorStocks, calendar, priceField,
+		Date::parse(startDate), Date::parse(endDate));
+	panel.normalizeToFirstSession();
+	stageReport.addStage("panel build", StageReport::secondsSince(stageStart));
+
+	// Score candidates from one spread-variance matrix of the whole panel when it fits, else pair by pair
+	const bool useGramMatrix = selectionConfig.scoring == SpreadScoring::GramMatrix ||
+		(selectionConfig.scoring == SpreadScoring::Auto && panel.symbolCount() <= Config::GRAM_MATRIX_MAX_SYMBOLS);
+	SpreadVarianceMatrix spreadVariances;
+	if (useGramMatrix) {
+		stageStart = std::chrono::steady_clock::now();
+		spreadVariances = SpreadVarianceMatrix::compute(panel);
+		stageReport.addStage("spread variance matrix", StageReport::secondsSince(stageStart));
+	}
+
+	// Spread buffer for the candidates that need exact statistics, and kernel scores reused for every base stock
+	const Eigen::Index sessionCount = static_cast<Eigen::Index>(panel.sessionCount());
+	Eigen::VectorXd spread(sessionCount);
+	std::vector<SpreadKernels::SpreadStatistics> scores;
+	ThreadPool::RunStatistics scoringRun;
+
+	// Lower bounds of the spread standard deviation of a base stock with each candidate
+	auto spreadLowerBounds = [&](std::size_t baseColumn, const std::vector<std::size_t>& candidates, std::vector<double>& lowerBounds) {
+		if (useGramMatrix) {
+			for (std::size_t k = 0; k < candidates.size(); ++k) {
+				lowerBounds[k] = spreadVariances.standardDeviationLowerBound(baseColumn, candidates[k]);
 			}
-		} catch(const std::exception& e){
-			std::cout << nyseListing << " error " << e.what() << " occured when checking for price-volume " << "\n"; 
-			toRemoveListings.push_back(nyseListing);
-			continue;
+			return;
 		}
-		
-		// Check if Stock has all valid dates identical to the SPY dates
-		if(!StockAnalysis::hasValidDataInRange(stock, SPY, priceType, startDate, endDate)){
-			std::cout << nyseListing << " does not have a valid date in between dates " << startDate << " " << endDate << "\n";
-			toRemoveListings.push_back(nyseListing);
-			continue;
+
+		// Chunks hold a multiple of four candidates, so the kernel groups them the same way for any thread count
+		scores.resize(candidates.size());
+		auto scoreChunk = [&](std::size_t begin, std::size_t end, unsigned int) {
+			SpreadKernels::spreadStatistics(panel.columnData(baseColumn), panel.getPrices().data(), panel.sessionCount(),
+				panel.sessionCount(), candidates.data() + begin, end - begin, scores.data() + begin);
+		};
+		if (candidates.size() > SCORING_CHUNK_SIZE) {
+			threadPool.parallelForChunks(candidates.size(), SCORING_CHUNK_SIZE, scoreChunk);
+			scoringRun.accumulate(threadPool.getLastRunStatistics());
+		} else {
+			scoreChunk(0, candidates.size(), 0);
 		}
-		
-		// Pre-load all the valid data into memory
-		stockAdjClose[nyseListing] = StockUtils::getPriceDataInRange(stock, priceType, startDate, endDate); // Store the stock in the dictionary;
-		std::cout << "--------------------------------------------------\n";
+		for (std::size_t k = 0; k < candidates.size(); ++k) {
+			lowerBounds[k] = scores[k].standardDeviationLowerBound;
+		}
+	};
+
+	// Exact spread standard deviation, the score the pairing decides on
+	auto spreadStandardDeviation = [&](std::size_t baseColumn, std::size_t comparisonColumn) {
+		spread.noalias() = panel.column(baseColumn) - panel.column(comparisonColumn);
+		return StockAnalysis::calculateStatistics(spread).second;
+	};
+
+	// Pair every listing, in listing order, with the remaining listing of lowest spread standard deviation
+	stageStart = std::chrono::steady_clock::now();
+	std::vector<GreedyPairing::Pair> chosenPairs = GreedyPairing::run(panel.symbolCount(), spreadLowerBounds, spreadStandardDeviation);
+	stageReport.addStage("pairing", StageReport::secondsSince(stageStart));
+	if (!scoringRun.busySeconds.empty()) {
+		stageReport.addStage("candidate scoring", scoringRun);
 	}
 
-	// Removing the filtered listings from the NYSE listings
-	stockListings.erase(std::remove_if(stockListings.begin(), stockListings.end(),
-									[&toRemoveListings](const std::string &str) {
-										return std::find(toRemoveListings.begin(), toRemoveListings.end(), str) != toRemoveListings.end();
-									}),
-					 stockListings.end());
-	toRemoveListings.clear();
-
-	// Precompute normalized data
-	std::unordered_map<std::string, std::unordered_map<std::string, double>> normalizedStockData;
-	for (const auto& [stock, data] : stockAdjClose) {
-		normalizedStockData[stock] = StockAnalysis::normalizeToEarliestDate(data);
-	}
+	// Calculate the statistics of every chosen pair in parallel; each pair writes only its own slot
+	std::vector<PairStatistics> chosenStatistics(chosenPairs.size());
+	std::vector<std::string> unitRootErrors(chosenPairs.size());
+	std::vector<Eigen::VectorXd> workerSpreads(threadPool.size(), Eigen::VectorXd(sessionCount));
+	threadPool.parallelFor(chosenPairs.size(), [&](std::size_t index, unsigned int worker) {
+		const GreedyPairing::Pair& chosen = chosenPairs[index];
+		Eigen::VectorXd& pairSpread = workerSpreads[worker];
+		PairStatistics& stats = chosenStatistics[index];
 
-	// Loop through all valid NYSE listings to find the best pairs
-	while(stockListings.size() > 1){
-		// Get the first stock of the NYSE listings
-		std::string baseStock = stockListings.at(0);
-		std::cout << "current base stock: " << baseStock << "\n";
-		
-		// Normalize the comparison stock
-		std::unordered_map<std::string, double> baseStockNormalized = normalizedStockData[baseStock];
-		
-		// Compare against all the other stock in NYSE listings
-		double currentStandardDeviation;
-		std::string comparisonStockToRemove;
-		PairStatistics stats;
-		for(int i = 1; i < stockListings.size(); ++i){
+		// Find the difference between the comparison stock to the base stock
+		pairSpread.noalias() = panel.column(chosen.base) - panel.column(chosen.partner);
 
+		// Calculate the statistics of the difference
+		std::pair<double, double> differenceStatistics = StockAnalysis::calculateStatistics(pairSpread); // {mean, standard deviation}
+
+		// Store the usual statistics
+		stats.mean = differenceStatistics.first;
+		stats.standardDeviation = differenceStatistics.second;
+		stats.pValue = 2.0 * (1.0 - StandardNormalDistribution::cdf(std::fabs(differenceStatistics.first) / differenceStatistics.second));
+
+		// For unit-root tests
+		try {
+			// Store the URT statistics; the battery shares one conversion of the spread across all eight tests
+			StockAnalysis::UnitRootPValues unitRoot = StockAnalysis::calculateUnitRootBattery(pairSpread, 10, "ct");
+			stats.adfPValueAIC = unitRoot.adfAIC;
+			stats.adfPValueBIC = unitRoot.adfBIC;
+			stats.ppPValueShortRho = unitRoot.ppShortRho;
+			stats.ppPValueLongRho = unitRoot.ppLongRho;
+			stats.ppPValueShortTau = unitRoot.ppShortTau;
+			stats.ppPValueLongTau = unitRoot.ppLongTau;
+			stats.kpssPValueShort = unitRoot.kpssShort;
+			stats.kpssPValueLong = unitRoot.kpssLong;
 			
-			// Get the comparison stock
-			std::string comparisonStock = stockListings.at(i);
-			//std::cout << "current comparison stock: " << comparisonStock << "\n";
-			
-			// Normalize the comparison stock
-			std::unordered_map<std::string, double> comparisonStockNormalized = normalizedStockData[comparisonStock];
-			
-			// Find the difference between the comparison stock to the base stock
-			std::unordered_map<std::string, double> differenceMap = StockAnalysis::calculateDifferenceBetweenData(baseStockNormalized, comparisonStockNormalized);
-			
-			// Calculate the statistics of the difference and store them dictionaries
-			// Store the pair statistic in an unordered_map
-			std::pair<double, double> differenceStatistics = StockAnalysis::calculateStatistics(differenceMap); // {mean, standard deviation}
-			StockAnalysis::clearCache();
-			
-			// Store the statistics in the pair maps and the difference map
-			if(i == 1 || differenceStatistics.second <  currentStandardDeviation){
-				// Storing only pairs that result in lower standard deviations
-				currentStandardDeviation = differenceStatistics.second;
-				comparisonStockToRemove = comparisonStock;
-				
-				// Store the usual statistics
-				stats.mean = differenceStatistics.first;
-				stats.standardDeviation = differenceStatistics.second;
-				stats.pValue = 2.0 * (1.0 - StandardNormalDistribution::cdf(std::fabs(differenceStatistics.first) / differenceStatistics.second));
-
-				// For unit-root tests
-				try {
-					// Store the URT statistics
-					stats.adfPValueAIC = StockAnalysis::calculatePValueForURT(differenceMap, "ADF", 10, "ct", "AIC");
-					stats.adfPValueBIC = StockAnalysis::calculatePValueForURT(differenceMap, "ADF", 10, "ct", "BIC");
-					stats.ppPValueShortRho = StockAnalysis::calculatePValueForURT(differenceMap, "PP", 10, "ct", "rho", "short");
-					stats.ppPValueLongRho = StockAnalysis::calculatePValueForURT(differenceMap, "PP", 10, "ct", "rho", "long");
-					stats.ppPValueShortTau = StockAnalysis::calculatePValueForURT(differenceMap, "PP", 10, "ct", "tau", "short");
-					stats.ppPValueLongTau = StockAnalysis::calculatePValueForURT(differenceMap, "PP", 10, "ct", "tau", "long");
-					stats.kpssPValueShort = StockAnalysis::calculatePValueForURT(differenceMap, "KPSS", 10, "ct", "", "short");
-					stats.kpssPValueLong = StockAnalysis::calculatePValueForURT(differenceMap, "KPSS", 10, "ct", "", "long");
-					
-				} catch (const std::exception& e) {
-					std::cout << "Encountered error during unit-root test with error \"" << e.what() << "\"\n";
-					stats.adfPValueAIC = -1;
-					stats.adfPValueBIC = -1;
-					stats.ppPValueShortRho = -1;
-					stats.ppPValueLongRho = -1;
-					stats.ppPValueShortTau = -1;
-					stats.ppPValueLongTau = -1;
-					stats.kpssPValueShort = -1;
-					stats.kpssPValueLong = -1;
-					
-				} // End of unit-root tests
-				
-			} // End of storing test statisitcs
+		} catch (const std::exception& e) {
+			unitRootErrors[index] = e.what();
+			stats.adfPValueAIC = -1;
+			stats.adfPValueBIC = -1;
+			stats.ppPValueShortRho = -1;
+			stats.ppPValueLongRho = -1;
+			stats.ppPValueShortTau = -1;
+			stats.ppPValueLongTau = -1;
+			stats.kpssPValueShort = -1;
+			stats.kpssPValueLong = -1;
 			
-		} // End of looping through comparison stocks
-		
-		// Add the pair object into the dictionary
-		const std::string pairKey = baseStock + "-" + comparisonStockToRemove;
-		pairStatistics[pairKey] = stats;
-		
-		// Removing the pairs from the NYSE listing
-		for(auto toRemove : {baseStock, comparisonStockToRemove}){
-			auto itr = std::find(stockListings.begin(), stockListings.end(), toRemove);
-			if (itr != stockListings.end()) stockListings.erase(itr);
+		} // End of unit-root tests
+	});
+	stageReport.addStage("pair statistics", threadPool.getLastRunStatistics());
+
+	// Merge in pairing order, so the output does not depend on the thread count
+	for (std::size_t index = 0; index < chosenPairs.size(); ++index) {
+		const std::string& baseStock = panel.getSymbol(chosenPairs[index].base);
+		std::cout << "current base stock: " << baseStock << "\n";
+		if (!unitRootErrors[index].empty()) {
+			std::cout << "Encountered error during unit-root test with error \"" << unitRootErrors[index] << "\"\n";
 		}
+
+		// Add the pair object into the dictionary
+		pairStatistics[baseStock + "-" + panel.getSymbol(chosenPairs[index].partner)] = chosenStatistics[index];
 		
 		std::cout << "--------------------------------------------------\n";
-	} //  End of looping through base stocks
+	} //  End of looping through chosen pairs
 
 	auto stop = std::chrono::high_resolution_clock::now();
 	auto duration = std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
@@ -320,10 +763,13 @@ std::map<std::string, PairsTradingBackTesting::PairStatistics> PairsTradingBackT
 	std::cout << "Time taken by function: "
 		 << duration.count() << " microseconds" << "\n";
 	;
+	if (selectionConfig.reportStageTimings) {
+		stageReport.print();
+	}
     return pairStatistics;
 }
 
-// Select pairs for backtesting
+// Select pairs for backtesting with the default selection settings
 std::unordered_map<std::string, PairsTradingBackTesting::LNpairStatistic> PairsTradingBackTesting::selectPairsForBackTesting(
 		const std::vector<std::string>& stockListings,
 		const std::string& stockDataDir,
@@ -333,57 +779,181 @@ std::unordered_map<std::string, PairsTradingBackTesting::LNpairStatistic> PairsT
 		const std::string& startDate, 
 		const std::string& endDate
 	) {
-	// Load benchmark stock data
-	Stock benchmarkStock;
-	FileReader::loadStockDataFromFile(stockDataDir + benchmarkSymbol + fileExtension, benchmarkStock);
-	auto benchmarkData = StockUtils::getPriceDataInRange(benchmarkStock, priceType, startDate, endDate);
-	auto normalizedBenchmarkData = StockAnalysis::normalizeToEarliestDate(benchmarkData);
+	return selectPairsForBackTesting(stockListings, stockDataDir, fileExtension, benchmarkSymbol, priceType,
+		startDate, endDate, SelectionConfig());
+}
 
-	// Store results
+// Select pairs for backtesting
+std::unordered_map<std::string, PairsTradingBackTesting::LNpairStatistic> PairsTradingBackTesting::selectPairsForBackTesting(
+		const std::vector<std::string>& stockListings,
+		const std::string& stockDataDir,
+		const std::string& fileExtension,		
+		const std::string& benchmarkSymbol,
+		const std::string& priceType, 
+		const std::string& startDate, 
+		const std::string& endDate,
+		const SelectionConfig& selectionConfig
+	) {
 	std::unordered_map<std::string, PairsTradingBackTesting::LNpairStatistic> pairResults;
+	screenAgainstBenchmark(stockListings, stockDataDir, fileExtension, benchmarkSymbol, priceType, startDate, endDate,
+		[&pairResults](const LNpairStatistic& row) { pairResults[row.pair] = row; }, selectionConfig);
+	return pairResults;
+}
 
-	for (const auto& stockSymbol : stockListings) {
-		Stock stock;
-		FileReader::loadStockDataFromFile(stockDataDir + stockSymbol + fileExtension, stock);
+// Screen every listing against the benchmark and stream the rows to the sink
+std::size_t PairsTradingBackTesting::screenAgainstBenchmark(
+		const std::vector<std::string>& stockListings,
+		const std::string& stockDataDir,
+		const std::string& fileExtension,
+		const std::string& benchmarkSymbol,
+		const std::string& priceType,
+		const std::string& startDate,
+		const std::string& endDate,
+		const BenchmarkRowSink& sink,
+		const SelectionConfig& selectionConfig
+	) {
+	// Load benchmark stock data
+	std::shared_ptr<const Stock> loadedBenchmark = StockDataStore::instance().get(stockDataDir, benchmarkSymbol, fileExtension);
+	const Stock& benchmarkStock = loadedBenchmark ? *loadedBenchmark : EMPTY_STOCK;
+	Series benchmarkData;
+	StockUtils::getPriceSeriesInRange(benchmarkStock, priceType, startDate, endDate, benchmarkData);
+	SeriesView normalizedBenchmarkData = StockAnalysis::normalizeToEarliestDate(benchmarkData, benchmarkData);
+
+	// Columnar price types are read in place; the others are copied into a buffer reused by each worker
+	Stock::Field field;
+	const bool columnar = Stock::parseField(priceType, field);
+	const Date start = Date::parse(startDate), end = Date::parse(endDate);
+
+	ThreadPool threadPool(selectionConfig.threadCount);
+	std::vector<Series> workerBuffers(threadPool.size());
+
+	// Every listing of a block writes only its own slot, so the rows reach the sink in listing order
+	const std::size_t blockSize = std::min(BENCHMARK_SCREEN_BLOCK_SIZE, stockListings.size());
+	std::vector<LNpairStatistic> blockResults(blockSize);
+	std::vector<std::string> blockErrors(blockSize);
+	std::vector<char> blockSucceeded(blockSize);
+
+	// Listings with a value on every benchmark session share x = 0 .. n-1, so their log differences are gathered as
+	// columns and regressed in one batched sweep; listings with gaps stream through the index accumulator instead
+	const Eigen::Index sessionCount = static_cast<Eigen::Index>(normalizedBenchmarkData.size());
+	const Eigen::VectorXd sessionIndex = Eigen::VectorXd::LinSpaced(sessionCount, 0.0, static_cast<double>(sessionCount - 1));
+	Eigen::MatrixXd blockLogDifferences(sessionCount, static_cast<Eigen::Index>(blockSize));
+	std::vector<char> blockComplete(blockSize);
+	std::vector<double> blockLastDifferences(blockSize);
+	std::vector<std::size_t> completeOffsets;
+	completeOffsets.reserve(blockSize);
+	std::vector<std::vector<StatisticalAnalysis::LinearRegressionResult>> workerRegressions(threadPool.size());
+	ThreadPool::RunStatistics screenStatistics;
+
+	// Row of one listing from its regression against the chronological index
+	auto makeRow = [&](const std::string& stockSymbol, const StatisticalAnalysis::LinearRegressionResult& stats,
+					   std::size_t n, double lastDifference) {
+		// Compute p-value
+		double testStatistic = stats.slope / stats.slopeError;
+		double pValue = StatisticalAnalysis::calculatePValue(testStatistic, static_cast<int>(n), "t");
+
+		return LNpairStatistic{
+			stockSymbol + "-" + benchmarkSymbol,
+			startDate + "-" + endDate,
+			stats.slope,
+			stats.slopeError,
+			static_cast<int>(n),
+			testStatistic,
+			pValue,
+			stats.rSquared,
+			lastDifference
+		};
+	};
+	std::size_t rowsWritten = 0;
+
+	for (std::size_t blockBegin = 0; blockBegin < stockListings.size(); blockBegin += blockSize) {
+		const std::size_t blockEnd = std::min(blockBegin + blockSize, stockListings.size());
+		std::fill(blockSucceeded.begin(), blockSucceeded.end(), 0);
+		std::fill(blockComplete.begin(), blockComplete.end(), 0);
+
+		threadPool.parallelFor(blockEnd - blockBegin, [&](std::size_t offset, unsigned int worker) {
+			const std::string& stockSymbol = stockListings[blockBegin + offset];
+			std::shared_ptr<const Stock> loadedStock = StockDataStore::instance().get(stockDataDir, stockSymbol, fileExtension);
+			const Stock& stock = loadedStock ? *loadedStock : EMPTY_STOCK;
+
+			try {
+				SeriesView rows = columnar
+					? StockUtils::getPriceSeriesInRange(stock, field, start, end)
+					: StockUtils::getPriceSeriesInRange(stock, priceType, startDate, endDate, workerBuffers[worker]);
+
+				// Normalise, difference and log; a complete listing is regressed with the rest of its block below
+				double lastDifference = 0.0;
+				if (writeCompleteLogDifferences(rows, normalizedBenchmarkData,
+						blockLogDifferences.col(static_cast<Eigen::Index>(offset)), lastDifference)) {
+					blockLastDifferences[offset] = lastDifference;
+					blockComplete[offset] = 1;
+					return;
+				}
+
+				// Listing with gaps: regress against the chronological index of the values it has
+				std::size_t n = 0;
+				auto stats = regressLogDifferences(rows, normalizedBenchmarkData, n, lastDifference);
+
+				// Store results
+				blockResults[offset] = makeRow(stockSymbol, stats, n, lastDifference);
+				blockSucceeded[offset] = 1;
+			} catch (const std::exception& e) {
+				blockErrors[offset] = e.what();
+			}
+		});
+		screenStatistics.accumulate(threadPool.getLastRunStatistics());
+
+		// Move the columns of the complete listings to the front, in listing order, and regress them in one sweep
+		completeOffsets.clear();
+		for (std::size_t offset = 0; offset < blockEnd - blockBegin; ++offset) {
+			if (!blockComplete[offset]) continue;
+			const Eigen::Index column = static_cast<Eigen::Index>(completeOffsets.size());
+			if (column != static_cast<Eigen::Index>(offset)) {
+				blockLogDifferences.col(column) = blockLogDifferences.col(static_cast<Eigen::Index>(offset));
+			}
+			completeOffsets.push_back(offset);
+		}
+		if (!completeOffsets.empty()) {
+			threadPool.parallelForChunks(completeOffsets.size(), BENCHMARK_REGRESSION_CHUNK_SIZE,
+				[&](std::size_t begin, std::size_t end, unsigned int worker) {
+					std::vector<StatisticalAnalysis::LinearRegressionResult>& regressions = workerRegressions[worker];
+					StatisticalAnalysis::linearRegression(sessionIndex,
+						blockLogDifferences.middleCols(static_cast<Eigen::Index>(begin), static_cast<Eigen::Index>(end - begin)),
+						regressions);
+					for (std::size_t k = begin; k < end; ++k) {
+						const std::size_t offset = completeOffsets[k];
+						try {
+							blockResults[offset] = makeRow(stockListings[blockBegin + offset], regressions[k - begin],
+								static_cast<std::size_t>(sessionCount), blockLastDifferences[offset]);
+							blockSucceeded[offset] = 1;
+						} catch (const std::exception& e) {
+							blockErrors[offset] = e.what();
+						}
+					}
+				});
+			screenStatistics.accumulate(threadPool.getLastRunStatistics());
+		}
 
-		try {
-			// Retrieve and normalize stock data
-			auto stockData = StockUtils::getPriceDataInRange(stock, priceType, startDate, endDate);
-			auto normalizedStockData = StockAnalysis::normalizeToEarliestDate(stockData);
-
-			// Calculate log differences
-			auto differences = StockAnalysis::calculateDifferenceBetweenData(normalizedStockData, normalizedBenchmarkData);
-			auto sortedDifferences = StockAnalysis::sortMap(differences);
-			auto logDifferences = StockAnalysis::applyMapOperation(differences, [](double value) {
-				return std::log(value);
-			});
-
-			// Perform linear regression
-			auto stats = StatisticalAnalysis::linearRegression(logDifferences);
-
-			// Compute p-value
-			double testStatistic = stats.slope / stats.slopeError;
-			double pValue = StatisticalAnalysis::calculatePValue(testStatistic, logDifferences.size(), "t");
-
-			// Store results
-			pairResults[stockSymbol + "-" + benchmarkSymbol] = {
-				stockSymbol + "-" + benchmarkSymbol,
-				startDate + "-" + endDate,
-				stats.slope,
-				stats.slopeError,
-				logDifferences.size(),
-				testStatistic,				
-				pValue,
-				stats.rSquared,
-				sortedDifferences.back().second // Last difference value
-			};
-		} catch (const std::exception& e) {
-			// Log error and continue
-			std::cerr << "Error processing pair " << stockSymbol << "-" << benchmarkSymbol << ": " << e.what() << "\n";
+		// Flush the block in listing order
+		for (std::size_t offset = 0; offset < blockEnd - blockBegin; ++offset) {
+			if (blockSucceeded[offset]) {
+				sink(blockResults[offset]);
+				rowsWritten++;
+			} else {
+				// Log error and continue
+				std::cerr << "Error processing pair " << stockListings[blockBegin + offset] << "-" << benchmarkSymbol
+						  << ": " << blockErrors[offset] << "\n";
+			}
 		}
 	}
 
-	return pairResults;
+	if (selectionConfig.reportStageTimings) {
+		StageReport stageReport;
+		stageReport.addStage("benchmark regressions", screenStatistics);
+		stageReport.print();
+	}
+
+	return rowsWritten;
 }
 
 void PairsTradingBackTesting::logResults(const std::string& filename) const {
@@ -395,14 +965,7 @@ void PairsTradingBackTesting::logResults(const std::string& filename) const {
     } else {
         file.open(filename, std::ios::out); // Create a new file
         // Write the header if creating a new file
-        file << "EntryDate,ExitDate";
-        for (const auto& element : trades.at(0).entryPrices) {
-            file << "," << element.first << " Entry Price";
-        }
-        for (const auto& element : trades.at(0).exitPrices) {
-            file << "," << element.first << " Exit Price";
-        }
-        file << ",ProfitLoss\n";
+        writeTradesHeader(file);
     }
 
     // Check if file opened successfully
@@ -412,17 +975,35 @@ void PairsTradingBackTesting::logResults(const std::string& filename) const {
     }
 
     // Append trade details to the file
-	file << stock1Name << "-" << stock2Name << "\n";
-    for (const auto& trade : trades) {
-        file << trade.entryDate << "," << trade.exitDate;
-        for (const auto& element : trade.entryPrices) {
-            file << "," << element.second;
-        }
-        for (const auto& element : trade.exitPrices) {
-            file << "," << element.second;
-        }
-        file << "," << trade.profitLoss << "\n";
-    }
-	file << "\n";
+    writeTrades(file);
     file.close();
-}
\ No newline at end of file
+}
+
+// Write the header line of the trades file
+void PairsTradingBackTesting::writeTradesHeader(std::ostream& os) const {
+    TextBuffer text;
+    writeTradesHeader(text);
+    os << text.str();
+}
+
+void PairsTradingBackTesting::writeTradesHeader(TextBuffer& out) const {
+    writeTradeHeader(out);
+}
+
+// Write the block of this pair's trades
+void PairsTradingBackTesting::writeTrades(std::ostream& os) const {
+    TextBuffer text;
+    writeTrades(text);
+    os << text.str();
+}
+
+void PairsTradingBackTesting::writeTrades(TextBuffer& out) const {
+	out << stock1Name << "-" << stock2Name << '\n';
+    writeTradeRows(out);
+	out << '\n';
+}
+
+// Send the progress messages of run() to another stream
+void PairsTradingBackTesting::setMessageStream(std::ostream& os) {
+    messageStream = &os;
+}
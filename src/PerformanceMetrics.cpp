@@ -0,0 +1,118 @@
+#include "PerformanceMetrics.hpp"
+
+PerformanceMetrics::PerformanceMetrics(double initialBalance)
+    : initialBalance(initialBalance),
+      realisedBalance(initialBalance),
+      realisedPeak(initialBalance),
+      equity(initialBalance),
+      equityPeak(initialBalance) {}
+
+// Keep the equity of every bar
+void PerformanceMetrics::keepEquityCurve(std::size_t sessionCount) {
+    keepCurve = true;
+    equityCurve.reserve(equityCurve.size() + sessionCount);
+}
+
+// Add the profit/loss of a closed trade
+void PerformanceMetrics::addTrade(double profitLoss) {
+    tradeReturns.add(initialBalance != 0.0 ? profitLoss / initialBalance : 0.0);
+
+    realisedBalance += profitLoss;
+    if (realisedBalance > realisedPeak) realisedPeak = realisedBalance;
+    if (realisedPeak <= 0.0) return;   // No fraction of a zero peak; BackTesting(0) starts there
+    double drawdown = (realisedPeak - realisedBalance) / realisedPeak;
+    if (drawdown > realisedMaxDrawdown) realisedMaxDrawdown = drawdown;
+}
+
+// Add one session's marked-to-market equity
+void PerformanceMetrics::addBar(double barEquity) {
+    dailyReturns.add(equity > 0.0 ? (barEquity - equity) / equity : 0.0);
+    equity = barEquity;
+    if (keepCurve) equityCurve.push_back(barEquity);
+
+    if (equity >= equityPeak) {
+        equityPeak = equity;
+        currentUnderWaterRun = 0;
+        return;
+    }
+    if (equityPeak > 0.0) {
+        double drawdown = (equityPeak - equity) / equityPeak;
+        if (drawdown > equityMaxDrawdown) equityMaxDrawdown = drawdown;
+    }
+    underWater++;
+    currentUnderWaterRun++;
+    if (currentUnderWaterRun > longestUnderWaterRun) longestUnderWaterRun = currentUnderWaterRun;
+}
+
+std::size_t PerformanceMetrics::tradeCount() const {
+    return tradeReturns.count;
+}
+
+double PerformanceMetrics::tradeSharpeRatio() const {
+    return tradeReturns.sharpeRatio();
+}
+
+double PerformanceMetrics::tradeSortinoRatio() const {
+    return tradeReturns.sortinoRatio();
+}
+
+double PerformanceMetrics::maxDrawdown() const {
+    return realisedMaxDrawdown;
+}
+
+std::size_t PerformanceMetrics::barCount() const {
+    return dailyReturns.count;
+}
+
+double PerformanceMetrics::dailySharpeRatio() const {
+    return dailyReturns.sharpeRatio();
+}
+
+double PerformanceMetrics::dailySortinoRatio() const {
+    return dailyReturns.sortinoRatio();
+}
+
+double PerformanceMetrics::maxDailyDrawdown() const {
+    return equityMaxDrawdown;
+}
+
+std::size_t PerformanceMetrics::timeUnderWater() const {
+    return underWater;
+}
+
+std::size_t PerformanceMetrics::longestTimeUnderWater() const {
+    return longestUnderWaterRun;
+}
+
+double PerformanceMetrics::getEquity() const {
+    return equity;
+}
+
+double PerformanceMetrics::getRealisedBalance() const {
+    return realisedBalance;
+}
+
+const std::vector<double>& PerformanceMetrics::getEquityCurve() const {
+    return equityCurve;
+}
+
+// Welford update of the mean and squared deviations
+void PerformanceMetrics::RunningMoments::add(double value) {
+    count++;
+    double delta = value - mean;
+    mean += delta / static_cast<double>(count);
+    sumSquaredDeviations += delta * (value - mean);
+    if (value < 0.0) sumSquaredShortfalls += value * value;
+}
+
+double PerformanceMetrics::RunningMoments::sharpeRatio() const {
+    if (count == 0) return 0.0;
+    double stddev = std::sqrt(sumSquaredDeviations / static_cast<double>(count));
+    return stddev == 0.0 ? 0.0 : mean / stddev;
+}
+
+double PerformanceMetrics::RunningMoments::sortinoRatio() const {
+    if (count == 0) return 0.0;
+    double downsideDeviation = std::sqrt(sumSquaredShortfalls / static_cast<double>(count));
+    return downsideDeviation == 0.0 ? 0.0 : mean / downsideDeviation;
+}
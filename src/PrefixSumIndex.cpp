@@ -0,0 +1,114 @@
+#include "PrefixSumIndex.hpp"
+
+namespace {
+    // Helper function to build prefix sums of a series, skipping NaN values; totals are carried in extended precision
+    template <typename ValueAt>
+    void buildPrefix(std::size_t rows, ValueAt valueAt, std::vector<double>& sums, std::vector<std::uint32_t>& counts) {
+        sums.resize(rows + 1);
+        counts.resize(rows + 1);
+        long double total = 0.0L;
+        std::uint32_t valid = 0;
+        sums[0] = 0.0;
+        counts[0] = 0;
+        for (std::size_t row = 0; row < rows; ++row) {
+            double value = valueAt(row);
+            if (!std::isnan(value)) {
+                total += value;
+                valid++;
+            }
+            sums[row + 1] = static_cast<double>(total);
+            counts[row + 1] = valid;
+        }
+    }
+}
+
+double PrefixSumIndex::RangeSummary::average() const {
+    if (count == 0) {
+        throw std::runtime_error("No valid data found within the specified date range.");
+    }
+    return sum / static_cast<double>(count);
+}
+
+PrefixSumIndex::PrefixSumIndex(const Stock& stock)
+    : dates(stock.getDates()) {
+    const std::size_t rows = dates.size();
+    for (std::size_t f = 0; f < Stock::FIELD_COUNT; ++f) {
+        const Stock::Column& column = stock.getColumn(static_cast<Stock::Field>(f));
+        buildPrefix(rows, [&column](std::size_t row) { return column[row]; },
+                    fieldPrefixes[f].sums, fieldPrefixes[f].counts);
+    }
+
+    const Stock::Column& volumes = stock.getColumn(Stock::Field::Volume);
+    for (std::size_t f = 0; f < PRICE_FIELD_COUNT; ++f) {
+        const Stock::Column& prices = stock.getColumn(static_cast<Stock::Field>(f));
+        buildPrefix(rows, [&prices, &volumes](std::size_t row) { return prices[row] * volumes[row]; },
+                    priceVolumePrefixes[f].sums, priceVolumePrefixes[f].counts);
+    }
+}
+
+// Summarise a raw column over a date range
+PrefixSumIndex::RangeSummary PrefixSumIndex::summarize(Stock::Field field, Date startDate, Date endDate) const {
+    auto [firstRow, lastRow] = rowRange(startDate, endDate);
+    return summarizeRows(field, firstRow, lastRow);
+}
+
+// Summarise price x volume over a date range
+PrefixSumIndex::RangeSummary PrefixSumIndex::summarizePriceVolume(Stock::Field priceField, Date startDate, Date endDate) const {
+    auto [firstRow, lastRow] = rowRange(startDate, endDate);
+    return summarizePriceVolumeRows(priceField, firstRow, lastRow);
+}
+
+PrefixSumIndex::RangeSummary PrefixSumIndex::summarizeRows(Stock::Field field, std::size_t firstRow, std::size_t lastRow) const {
+    return summarizePrefix(fieldPrefixes[static_cast<std::size_t>(field)], firstRow, lastRow);
+}
+
+PrefixSumIndex::RangeSummary PrefixSumIndex::summarizePriceVolumeRows(Stock::Field priceField, std::size_t firstRow, std::size_t lastRow) const {
+    return summarizePrefix(priceVolumePrefixes[static_cast<std::size_t>(priceField)], firstRow, lastRow);
+}
+
+double PrefixSumIndex::sum(Stock::Field field, Date startDate, Date endDate) const {
+    return summarize(field, startDate, endDate).sum;
+}
+
+std::size_t PrefixSumIndex::count(Stock::Field field, Date startDate, Date endDate) const {
+    return summarize(field, startDate, endDate).count;
+}
+
+double PrefixSumIndex::average(Stock::Field field, Date startDate, Date endDate) const {
+    return summarize(field, startDate, endDate).average();
+}
+
+double PrefixSumIndex::averagePriceVolume(Stock::Field priceField, Date startDate, Date endDate) const {
+    return summarizePriceVolume(priceField, startDate, endDate).average();
+}
+
+std::size_t PrefixSumIndex::size() const {
+    return dates.size();
+}
+
+std::size_t PrefixSumIndex::memoryUsage() const {
+    std::size_t bytes = sizeof(PrefixSumIndex) + dates.capacity() * sizeof(Date);
+    for (const auto& prefix : fieldPrefixes) {
+        bytes += prefix.sums.capacity() * sizeof(double) + prefix.counts.capacity() * sizeof(std::uint32_t);
+    }
+    for (const auto& prefix : priceVolumePrefixes) {
+        bytes += prefix.sums.capacity() * sizeof(double) + prefix.counts.capacity() * sizeof(std::uint32_t);
+    }
+    return bytes;
+}
+
+// Helper function to find the rows within a date range
+std::pair<std::size_t, std::size_t> PrefixSumIndex::rowRange(Date startDate, Date endDate) const {
+    auto first = std::lower_bound(dates.begin(), dates.end(), startDate);
+    auto last = std::upper_bound(first, dates.end(), endDate);
+    return {static_cast<std::size_t>(first - dates.begin()), static_cast<std::size_t>(last - dates.begin())};
+}
+
+// Helper function to read a range out of prefix arrays
+PrefixSumIndex::RangeSummary PrefixSumIndex::summarizePrefix(const PrefixColumn& prefix, std::size_t firstRow, std::size_t lastRow) {
+    RangeSummary summary;
+    if (lastRow <= firstRow || prefix.sums.empty()) return summary;
+    summary.sum = prefix.sums[lastRow] - prefix.sums[firstRow];
+    summary.count = prefix.counts[lastRow] - prefix.counts[firstRow];
+    return summary;
+}
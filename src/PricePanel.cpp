@@ -0,0 +1,74 @@
+#include "PricePanel.hpp"
+
+// Build the panel over the calendar sessions in a date range
+PricePanel PricePanel::build(const std::vector<std::string>& symbols,
+                             const std::vector<std::shared_ptr<const Stock>>& stocks,
+                             const TradingCalendar& calendar, Stock::Field field,
+                             Date startDate, Date endDate) {
+    if (symbols.size() != stocks.size()) {
+        throw std::invalid_argument("PricePanel::build needs one stock per symbol.");
+    }
+
+    PricePanel panel;
+    auto [sessionFirst, sessionLast] = calendar.getRange(startDate, endDate);
+    panel.sessions.assign(calendar.getSessions().begin() + static_cast<std::ptrdiff_t>(sessionFirst),
+                          calendar.getSessions().begin() + static_cast<std::ptrdiff_t>(sessionLast));
+    panel.symbols = symbols;
+    panel.prices.resize(static_cast<Eigen::Index>(panel.sessions.size()), static_cast<Eigen::Index>(symbols.size()));
+
+    for (std::size_t j = 0; j < symbols.size(); ++j) {
+        panel.symbolIndices.emplace(symbols[j], j);
+        if (!stocks[j]) {
+            throw std::invalid_argument("No data for " + symbols[j] + " when building the price panel.");
+        }
+
+        // Walk the stock's rows and the sessions together; both are sorted by date
+        const Stock& stock = *stocks[j];
+        const auto& dates = stock.getDates();
+        const auto& values = stock.getColumn(field);
+        std::size_t row = stock.getRange(startDate, endDate).first;
+        double* out = panel.prices.col(static_cast<Eigen::Index>(j)).data();
+        for (std::size_t t = 0; t < panel.sessions.size(); ++t) {
+            while (row < dates.size() && (dates[row] < panel.sessions[t] || std::isnan(values[row]))) row++;
+            if (row == dates.size() || dates[row] != panel.sessions[t]) {
+                throw std::invalid_argument(symbols[j] + " has no data on session " + panel.sessions[t].toString());
+            }
+            out[t] = values[row++];
+        }
+    }
+    return panel;
+}
+
+// Divide every column by its first value, in place
+void PricePanel::normalizeToFirstSession() {
+    if (prices.rows() == 0) return;
+    for (Eigen::Index j = 0; j < prices.cols(); ++j) {
+        double baseValue = prices(0, j);
+        if (baseValue == 0) {
+            throw std::runtime_error("The price value on the earliest date is zero, cannot normalize " + symbols[static_cast<std::size_t>(j)] + ".");
+        }
+        prices.col(j) /= baseValue;
+    }
+}
+
+std::size_t PricePanel::sessionCount() const { return sessions.size(); }
+std::size_t PricePanel::symbolCount() const { return symbols.size(); }
+
+const Eigen::MatrixXd& PricePanel::getPrices() const { return prices; }
+const std::vector<Date>& PricePanel::getSessions() const { return sessions; }
+const std::vector<std::string>& PricePanel::getSymbols() const { return symbols; }
+const std::string& PricePanel::getSymbol(std::size_t column) const { return symbols.at(column); }
+
+// Find the column of a symbol
+std::int64_t PricePanel::symbolIndex(const std::string& symbol) const {
+    auto it = symbolIndices.find(symbol);
+    return it == symbolIndices.end() ? -1 : static_cast<std::int64_t>(it->second);
+}
+
+PricePanel::ConstColumn PricePanel::column(std::size_t index) const {
+    return ConstColumn(columnData(index), prices.rows());
+}
+
+const double* PricePanel::columnData(std::size_t index) const {
+    return prices.data() + static_cast<std::ptrdiff_t>(index) * prices.rows();
+}
@@ -0,0 +1,104 @@
+#include "ResultSink.hpp"
+#include <chrono>
+
+namespace {
+    // Longest the writer thread sleeps before looking at the queue again, in case a wake-up was missed
+    const std::chrono::milliseconds WRITER_POLL_INTERVAL(1);
+}
+
+ResultSink::ResultSink(std::vector<std::ostream*> channels, std::size_t bufferSize)
+    : channels(std::move(channels)), bufferSize(bufferSize) {
+    // Buffers grow with what is written to them, so an idle channel costs nothing
+    buffers.resize(this->channels.size());
+
+    Node* stub = new Node();
+    head.store(stub);
+    tail = stub;
+    writer = std::thread(&ResultSink::writeLoop, this);
+}
+
+ResultSink::~ResultSink() {
+    close();
+    delete tail;
+}
+
+// Hand over a record
+void ResultSink::submit(Record record) {
+    Node* node = new Node();
+    node->record = std::move(record);
+    Node* previous = head.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+    wake.notify_one();
+}
+
+// Write every submitted record and flush the channels
+void ResultSink::close() {
+    if (closing.exchange(true)) return;
+    wake.notify_one();
+    writer.join();
+    for (std::size_t channel = 0; channel < channels.size(); ++channel) {
+        flush(channel);
+        channels[channel]->flush();
+    }
+}
+
+// Take the oldest record of the queue; the node it came from becomes the new stub
+bool ResultSink::pop(Record& record) {
+    Node* next = tail->next.load(std::memory_order_acquire);
+    if (next == nullptr) return false;
+    record = std::move(next->record);
+    delete tail;
+    tail = next;
+    return true;
+}
+
+// Put the records back into sequence order and write them out
+void ResultSink::writeLoop() {
+    std::map<std::uint64_t, Record> pending;   // Records that arrived ahead of their turn
+    std::uint64_t nextSequence = 0;
+    Record record;
+    while (true) {
+        // Read closing first: every record submitted before close() is in the queue by then
+        const bool finishing = closing.load(std::memory_order_acquire);
+        bool received = false;
+        while (pop(record)) {
+            received = true;
+            if (record.sequence == nextSequence) {
+                append(record);
+                nextSequence++;
+                for (auto it = pending.begin(); it != pending.end() && it->first == nextSequence; it = pending.erase(it)) {
+                    append(it->second);
+                    nextSequence++;
+                }
+            } else {
+                std::uint64_t sequence = record.sequence;
+                pending.emplace(sequence, std::move(record));
+            }
+        }
+
+        if (finishing && !received) break;
+        if (!received) {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wake.wait_for(lock, WRITER_POLL_INTERVAL);
+        }
+    }
+
+    // Records after a gap keep their relative order
+    for (auto& [sequence, late] : pending) append(late);
+}
+
+// Add a record's text to the channel buffers
+void ResultSink::append(Record& record) {
+    if (record.finalize) record.finalize(record.chunks);
+    for (std::size_t channel = 0; channel < record.chunks.size() && channel < channels.size(); ++channel) {
+        buffers[channel] += record.chunks[channel];
+        if (buffers[channel].size() >= bufferSize) flush(channel);
+    }
+}
+
+// Write a channel buffer out
+void ResultSink::flush(std::size_t channel) {
+    if (buffers[channel].empty()) return;
+    channels[channel]->write(buffers[channel].data(), static_cast<std::streamsize>(buffers[channel].size()));
+    buffers[channel].clear();
+}
@@ -0,0 +1,36 @@
+#include "SeriesView.hpp"
+
+void Series::reserve(std::size_t n) {
+    dates.reserve(n);
+    values.reserve(n);
+}
+
+void Series::resize(std::size_t n) {
+    dates.resize(n);
+    values.resize(n);
+}
+
+void Series::clear() {
+    dates.clear();
+    values.clear();
+}
+
+void Series::push_back(Date date, double value) {
+    dates.push_back(date);
+    values.push_back(value);
+}
+
+// Copy a series into this buffer
+void Series::assign(SeriesView source) {
+    // A view into this buffer (e.g. a subView of view()) is shifted down in place
+    std::less<const Date*> before;
+    if (!dates.empty() && !before(source.dates(), dates.data()) && before(source.dates(), dates.data() + dates.size())) {
+        std::size_t offset = static_cast<std::size_t>(source.dates() - dates.data());
+        std::copy(dates.begin() + offset, dates.begin() + offset + source.size(), dates.begin());
+        std::copy(values.begin() + offset, values.begin() + offset + source.size(), values.begin());
+        resize(source.size());
+        return;
+    }
+    dates.assign(source.dates(), source.dates() + source.size());
+    values.assign(source.values(), source.values() + source.size());
+}
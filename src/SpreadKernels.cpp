@@ -0,0 +1,181 @@
+#include "SpreadKernels.hpp"
+#include <cmath>
+#include <limits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SPREADKERNELS_HAVE_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace {
+    // Sums of the spread around a shift, the spread's first value. Shifting keeps the one-pass variance
+    // sum(d^2) - sum(d)^2 / n well conditioned when the spread sits far from zero.
+    struct ShiftedSums {
+        double shift = 0.0;
+        double sum = 0.0;
+        double sumSquares = 0.0;
+    };
+
+    SpreadKernels::SpreadStatistics finish(const ShiftedSums& sums, std::size_t n) {
+        SpreadKernels::SpreadStatistics stats;
+        if (n == 0) return stats;
+        const double count = static_cast<double>(n);
+        double variance = (sums.sumSquares - sums.sum * sums.sum / count) / count;
+        stats.mean = sums.shift + sums.sum / count;
+        stats.standardDeviation = std::sqrt(variance > 0.0 ? variance : 0.0);
+
+        // Rounding error bound, with u the unit roundoff and d the shifted differences:
+        // - each computed d is off by at most u(|shift| + 2|d|), which moves the standard deviation by at most the RMS
+        //   of those errors, u(|shift| + 2 RMS(d));
+        // - the sums, in any order, carry at most about (3n + 8)u E[d^2] into the variance;
+        // - the two-pass computation rounds a - b, moving its standard deviation by at most u(|shift| + RMS(d)), and
+        //   its sums lower its variance by at most (n + 3)u relative (an inexact mean only raises it).
+        // epsilon is 2u, so every term below has a factor of two to spare
+        const double epsilon = std::numeric_limits<double>::epsilon();
+        const double secondMoment = sums.sumSquares > 0.0 ? sums.sumSquares / count : 0.0;
+        const double rms = std::sqrt(secondMoment);
+        const double sumsBound = variance - (3.0 * count + 8.0) * epsilon * secondMoment;
+        double lower = (sumsBound > 0.0 ? std::sqrt(sumsBound) : 0.0) - epsilon * (2.0 * std::fabs(sums.shift) + 3.0 * rms);
+        lower *= 1.0 - (count + 3.0) * epsilon;
+        stats.standardDeviationLowerBound = lower > 0.0 ? lower : 0.0;
+        return stats;
+    }
+
+    // Helper function for the scalar path; two accumulators break the dependency chain
+    ShiftedSums scalarSums(const double* a, const double* b, std::size_t n, double shift) {
+        double sum0 = 0.0, sum1 = 0.0, squares0 = 0.0, squares1 = 0.0;
+        std::size_t i = 0;
+        for (; i + 2 <= n; i += 2) {
+            double d0 = a[i] - b[i] - shift;
+            double d1 = a[i + 1] - b[i + 1] - shift;
+            sum0 += d0;
+            sum1 += d1;
+            squares0 += d0 * d0;
+            squares1 += d1 * d1;
+        }
+        for (; i < n; ++i) {
+            double d = a[i] - b[i] - shift;
+            sum0 += d;
+            squares0 += d * d;
+        }
+        return {shift, sum0 + sum1, squares0 + squares1};
+    }
+
+#ifdef SPREADKERNELS_HAVE_AVX2
+    __attribute__((target("avx2")))
+    double horizontalSum(__m256d v) {
+        __m128d low = _mm256_castpd256_pd128(v);
+        __m128d high = _mm256_extractf128_pd(v, 1);
+        low = _mm_add_pd(low, high);
+        return _mm_cvtsd_f64(_mm_add_sd(low, _mm_unpackhi_pd(low, low)));
+    }
+
+    // Helper function for the AVX2 path on one pair of series
+    __attribute__((target("avx2")))
+    ShiftedSums avx2Sums(const double* a, const double* b, std::size_t n, double shift) {
+        const __m256d shiftVector = _mm256_set1_pd(shift);
+        __m256d sum0 = _mm256_setzero_pd(), sum1 = _mm256_setzero_pd();
+        __m256d squares0 = _mm256_setzero_pd(), squares1 = _mm256_setzero_pd();
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256d d0 = _mm256_sub_pd(_mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)), shiftVector);
+            __m256d d1 = _mm256_sub_pd(_mm256_sub_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4)), shiftVector);
+            sum0 = _mm256_add_pd(sum0, d0);
+            sum1 = _mm256_add_pd(sum1, d1);
+            squares0 = _mm256_add_pd(squares0, _mm256_mul_pd(d0, d0));
+            squares1 = _mm256_add_pd(squares1, _mm256_mul_pd(d1, d1));
+        }
+        for (; i + 4 <= n; i += 4) {
+            __m256d d = _mm256_sub_pd(_mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)), shiftVector);
+            sum0 = _mm256_add_pd(sum0, d);
+            squares0 = _mm256_add_pd(squares0, _mm256_mul_pd(d, d));
+        }
+
+        ShiftedSums sums{shift, horizontalSum(_mm256_add_pd(sum0, sum1)), horizontalSum(_mm256_add_pd(squares0, squares1))};
+        for (; i < n; ++i) {
+            double d = a[i] - b[i] - shift;
+            sums.sum += d;
+            sums.sumSquares += d * d;
+        }
+        return sums;
+    }
+
+    // Helper function for the AVX2 path scoring one base series against four columns; each base load is shared
+    __attribute__((target("avx2")))
+    void avx2Sums4(const double* base, const double* const* columns, std::size_t n, ShiftedSums* out) {
+        __m256d shifts[4], sums[4], squares[4];
+        for (int k = 0; k < 4; ++k) {
+            out[k].shift = base[0] - columns[k][0];
+            shifts[k] = _mm256_set1_pd(out[k].shift);
+            sums[k] = _mm256_setzero_pd();
+            squares[k] = _mm256_setzero_pd();
+        }
+
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256d baseValues = _mm256_loadu_pd(base + i);
+            for (int k = 0; k < 4; ++k) {
+                __m256d d = _mm256_sub_pd(_mm256_sub_pd(baseValues, _mm256_loadu_pd(columns[k] + i)), shifts[k]);
+                sums[k] = _mm256_add_pd(sums[k], d);
+                squares[k] = _mm256_add_pd(squares[k], _mm256_mul_pd(d, d));
+            }
+        }
+
+        for (int k = 0; k < 4; ++k) {
+            out[k].sum = horizontalSum(sums[k]);
+            out[k].sumSquares = horizontalSum(squares[k]);
+            for (std::size_t j = i; j < n; ++j) {
+                double d = base[j] - columns[k][j] - out[k].shift;
+                out[k].sum += d;
+                out[k].sumSquares += d * d;
+            }
+        }
+    }
+#endif
+
+    bool detectAvx2() {
+#ifdef SPREADKERNELS_HAVE_AVX2
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+
+    const bool HAS_AVX2 = detectAvx2();
+}
+
+bool SpreadKernels::usesAvx2() {
+    return HAS_AVX2;
+}
+
+// Compute the mean and standard deviation of a - b in one pass
+SpreadKernels::SpreadStatistics SpreadKernels::spreadStatistics(const double* a, const double* b, std::size_t n) {
+    if (n == 0) return SpreadStatistics();
+    const double shift = a[0] - b[0];
+#ifdef SPREADKERNELS_HAVE_AVX2
+    if (HAS_AVX2) return finish(avx2Sums(a, b, n, shift), n);
+#endif
+    return finish(scalarSums(a, b, n, shift), n);
+}
+
+// Score one base series against several matrix columns
+void SpreadKernels::spreadStatistics(const double* base, const double* matrix, std::size_t rows,
+                                     std::size_t leadingDimension, const std::size_t* columns,
+                                     std::size_t columnCount, SpreadStatistics* out) {
+    std::size_t k = 0;
+#ifdef SPREADKERNELS_HAVE_AVX2
+    if (HAS_AVX2 && rows > 0) {
+        ShiftedSums sums[4];
+        const double* block[4];
+        for (; k + 4 <= columnCount; k += 4) {
+            for (int c = 0; c < 4; ++c) block[c] = matrix + columns[k + c] * leadingDimension;
+            avx2Sums4(base, block, rows, sums);
+            for (int c = 0; c < 4; ++c) out[k + c] = finish(sums[c], rows);
+        }
+    }
+#endif
+    for (; k < columnCount; ++k) {
+        out[k] = spreadStatistics(base, matrix + columns[k] * leadingDimension, rows);
+    }
+}
@@ -0,0 +1,66 @@
+#include "SpreadVarianceMatrix.hpp"
+#include <limits>
+
+namespace {
+    // Safety factor on the rounding error bound n * epsilon of the covariance sums
+    const double ERROR_SAFETY_FACTOR = 16.0;
+}
+
+// Compute the spread variance of every pair of panel columns
+SpreadVarianceMatrix SpreadVarianceMatrix::compute(const PricePanel& panel) {
+    SpreadVarianceMatrix result;
+    const Eigen::MatrixXd& prices = panel.getPrices();
+    const Eigen::Index sessions = prices.rows();
+    const Eigen::Index symbols = prices.cols();
+    if (sessions == 0 || symbols == 0) return result;
+
+    // Centre every column, then C = Xc^T Xc / n through one rank update of the lower triangle. The centred copy is
+    // freed before the result is filled in, so at most one symbols x symbols matrix is alive at a time
+    Eigen::MatrixXd covariance = Eigen::MatrixXd::Zero(symbols, symbols);
+    {
+        Eigen::MatrixXd centred = prices.rowwise() - prices.colwise().mean();
+        covariance.selfadjointView<Eigen::Lower>().rankUpdate(centred.transpose(), 1.0 / static_cast<double>(sessions));
+    }
+
+    // Rounding of both the centring and the sums scales with each column's second moment about zero
+    result.secondMoments = prices.colwise().squaredNorm().transpose() / static_cast<double>(sessions);
+
+    // Turn the covariance into spread variances in place: the diagonal is kept aside, each lower-triangle entry is
+    // replaced by its spread variance and mirrored into the unused upper triangle
+    const Eigen::VectorXd columnVariances = covariance.diagonal();
+    for (Eigen::Index j = 0; j < symbols; ++j) {
+        covariance(j, j) = 0.0;
+        for (Eigen::Index i = j + 1; i < symbols; ++i) {
+            double variance = columnVariances(j) + columnVariances(i) - 2.0 * covariance(i, j);
+            covariance(i, j) = variance;
+            covariance(j, i) = variance;
+        }
+    }
+    result.variances = std::move(covariance);
+
+    result.relativeError = ERROR_SAFETY_FACTOR * static_cast<double>(sessions) * std::numeric_limits<double>::epsilon();
+    return result;
+}
+
+std::size_t SpreadVarianceMatrix::size() const {
+    return static_cast<std::size_t>(variances.rows());
+}
+
+double SpreadVarianceMatrix::variance(std::size_t i, std::size_t j) const {
+    return variances(static_cast<Eigen::Index>(i), static_cast<Eigen::Index>(j));
+}
+
+double SpreadVarianceMatrix::errorBound(std::size_t i, std::size_t j) const {
+    return relativeError * (secondMoments(static_cast<Eigen::Index>(i)) + secondMoments(static_cast<Eigen::Index>(j)))
+        + std::numeric_limits<double>::min();
+}
+
+// Get a lower bound of the exact spread standard deviation
+double SpreadVarianceMatrix::standardDeviationLowerBound(std::size_t i, std::size_t j) const {
+    double lower = variance(i, j) - errorBound(i, j);
+    return lower > 0.0 ? std::sqrt(lower) : 0.0;
+}
+
+const Eigen::MatrixXd& SpreadVarianceMatrix::getVariances() const {
+    return variances;
+}
@@ -0,0 +1,51 @@
+#include "StageReport.hpp"
+#include <iomanip>
+
+// Record a serial stage
+void StageReport::addStage(const std::string& name, double wallSeconds) {
+    findOrAdd(name).wallSeconds += wallSeconds;
+}
+
+// Record a parallel stage
+void StageReport::addStage(const std::string& name, const ThreadPool::RunStatistics& statistics) {
+    Stage& stage = findOrAdd(name);
+    stage.parallel = true;
+    stage.wallSeconds += statistics.wallSeconds;
+    stage.statistics.accumulate(statistics);
+}
+
+// Print one line per stage
+void StageReport::print(std::ostream& os) const {
+    std::ios_base::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+    os << std::fixed;
+    for (const Stage& stage : stages) {
+        os << "Stage " << stage.name << ": " << std::setprecision(4) << stage.wallSeconds << " s";
+        if (stage.parallel) {
+            const ThreadPool::RunStatistics& statistics = stage.statistics;
+            os << ", " << statistics.busySeconds.size() << " threads, " << std::setprecision(1)
+               << 100.0 * statistics.utilisation() << "% utilisation, " << statistics.steals << " steals (busy per thread:";
+            for (double busy : statistics.busySeconds) {
+                os << " " << (statistics.wallSeconds > 0.0 ? 100.0 * busy / statistics.wallSeconds : 0.0) << "%";
+            }
+            os << ")";
+        }
+        os << "\n";
+    }
+    os.flags(flags);
+    os.precision(precision);
+}
+
+double StageReport::secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Helper function to find a stage by name, appending it if it is new
+StageReport::Stage& StageReport::findOrAdd(const std::string& name) {
+    for (Stage& stage : stages) {
+        if (stage.name == name) return stage;
+    }
+    stages.push_back(Stage());
+    stages.back().name = name;
+    return stages.back();
+}
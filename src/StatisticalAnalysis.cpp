@@ -2,35 +2,111 @@
 
 // Linear regression: Returns intercept, slope, and their standard errors
 StatisticalAnalysis::LinearRegressionResult StatisticalAnalysis::linearRegression (
-	const Eigen::VectorXd& x, 
-	const Eigen::VectorXd& y) {
-	int n = x.size();
+	const Eigen::Ref<const Eigen::VectorXd>& x, 
+	const Eigen::Ref<const Eigen::VectorXd>& y) {
+	const Eigen::Index n = x.size();
 	if (n != y.size()) {
 		throw std::invalid_argument("x and y must have the same length");
 	}
 
-	// Design matrix with intercept term
-	Eigen::MatrixXd X(n, 2);
-	X.col(0) = Eigen::VectorXd::Ones(n);  // Intercept column
-	X.col(1) = x;
+	// Running means and centred co-moments (Welford), stable without a second pass
+	double meanX = 0.0, meanY = 0.0, sxx = 0.0, sxy = 0.0, syy = 0.0;
+	for (Eigen::Index i = 0; i < n; ++i) {
+		const double count = static_cast<double>(i + 1);
+		const double dx = x[i] - meanX;
+		const double dy = y[i] - meanY;
+		meanX += dx / count;
+		meanY += dy / count;
+		sxx += dx * (x[i] - meanX);
+		sxy += dx * (y[i] - meanY);
+		syy += dy * (y[i] - meanY);
+	}
+
+	return regressionFromMoments(static_cast<double>(n), meanX, meanY, sxx, sxy, syy);
+}
+
+// Linear regression on the chronological index 0 .. n-1
+StatisticalAnalysis::LinearRegressionResult StatisticalAnalysis::linearRegressionOnIndex(
+	const Eigen::Ref<const Eigen::VectorXd>& y) {
+	IndexRegressionAccumulator accumulator;
+	for (Eigen::Index i = 0; i < y.size(); ++i) {
+		accumulator.add(y[i]);
+	}
+	return accumulator.result();
+}
+
+// Method to add the next value of the series
+void StatisticalAnalysis::IndexRegressionAccumulator::add(double y) {
+	// Sums of y around its first value keep the one-pass Syy well conditioned
+	if (n == 0) shift = y;
+	const double d = y - shift;
+	sum += d;
+	sumSquares += d * d;
+	sumIndexProducts += static_cast<double>(n) * d;
+	++n;
+}
+
+// Method to fit the values added so far
+StatisticalAnalysis::LinearRegressionResult StatisticalAnalysis::IndexRegressionAccumulator::result() const {
+	const double count = static_cast<double>(n);
+
+	// The index has mean (n-1)/2 and Sxx = n(n^2-1)/12
+	const double meanX = (count - 1.0) / 2.0;
+	const double sxx = count * (count * count - 1.0) / 12.0;
+	const double sxy = sumIndexProducts - meanX * sum;
+	const double syy = sumSquares - sum * sum / count;
+
+	return regressionFromMoments(count, meanX, shift + sum / count, sxx, sxy, syy);
+}
+
+// Batched linear regression of many columns on a shared x
+void StatisticalAnalysis::linearRegression(
+	const Eigen::Ref<const Eigen::VectorXd>& x, const Eigen::Ref<const Eigen::MatrixXd>& ys,
+	std::vector<LinearRegressionResult>& results) {
+	const Eigen::Index n = x.size();
+	if (n != ys.rows()) {
+		throw std::invalid_argument("x and y must have the same length");
+	}
+
+	// The x side is shared by every column
+	const double count = static_cast<double>(n);
+	const double meanX = x.mean();
+	const Eigen::VectorXd centredX = x.array() - meanX;
+	const double sxx = centredX.squaredNorm();
+
+	results.resize(static_cast<std::size_t>(ys.cols()));
+	for (Eigen::Index j = 0; j < ys.cols(); ++j) {
+		const double shift = n > 0 ? ys(0, j) : 0.0;
+		double sum = 0.0, sumSquares = 0.0, sxy = 0.0;
+		for (Eigen::Index i = 0; i < n; ++i) {
+			const double d = ys(i, j) - shift;
+			sum += d;
+			sumSquares += d * d;
+			sxy += centredX[i] * d;
+		}
+		const double syy = sumSquares - sum * sum / count;
+		results[static_cast<std::size_t>(j)] = regressionFromMoments(count, meanX, shift + sum / count, sxx, sxy, syy);
+	}
+}
 
-	// Solve for coefficients: beta = (X^T X)^-1 X^T y
-	Eigen::VectorXd beta = (X.transpose() * X).inverse() * X.transpose() * y;
-	double b0 = beta(0);  // Intercept
-	double b1 = beta(1);  // Slope
+// Helper to turn the centred sums of a simple regression into its result
+StatisticalAnalysis::LinearRegressionResult StatisticalAnalysis::regressionFromMoments(
+	double n, double meanX, double meanY, double sxx, double sxy, double syy) {
+	// Solve for coefficients
+	double b1 = sxy / sxx;          // Slope
+	double b0 = meanY - b1 * meanX; // Intercept
 
-	// Calculate residuals and residual variance
-	Eigen::VectorXd residuals = y - X * beta;
-	double residualVariance = residuals.squaredNorm() / (n - 2);
+	// Residual sum of squares and residual variance
+	double residualSumSquares = syy - b1 * sxy;
+	if (residualSumSquares < 0.0) residualSumSquares = 0.0;
+	double residualVariance = residualSumSquares / (n - 2.0);
 
-	// Standard errors: sqrt(residualVariance * diag((X^T X)^-1))
-	Eigen::MatrixXd XtX_inv = (X.transpose() * X).inverse();
-	double se_b0 = std::sqrt(residualVariance * XtX_inv(0, 0));
-	double se_b1 = std::sqrt(residualVariance * XtX_inv(1, 1));
+	// Standard errors: sqrt(residualVariance * diag((X^T X)^-1)), with (X^T X)^-1 in closed form
+	double se_b0 = std::sqrt(residualVariance * (1.0 / n + meanX * meanX / sxx));
+	double se_b1 = std::sqrt(residualVariance / sxx);
 
     // Calculate R^2
-    double totalVariance = (y.array() - y.mean()).matrix().squaredNorm();
-    double rSquared = 1.0 - residuals.squaredNorm() / totalVariance;
+    double rSquared = 1.0 - residualSumSquares / syy;
 
 	// Return results
 	return {b0, b1, se_b0, se_b1, rSquared};
@@ -45,17 +121,14 @@ StatisticalAnalysis::LinearRegressionResult StatisticalAnalysis::linearRegressio
 		return a.first < b.first;  // Compare dates lexicographically
 	});
 
-	// Step 2: Convert sorted data into Eigen vectors
-	int n = sortedData.size();
-	Eigen::VectorXd x(n);
-	Eigen::VectorXd y(n);
-	for (int i = 0; i < n; ++i) {
-		x[i] = i;  // Chronological index
-		y[i] = sortedData[i].second;  // Corresponding value
+	// Step 2: Gather the values in chronological order
+	Eigen::VectorXd y(static_cast<Eigen::Index>(sortedData.size()));
+	for (std::size_t i = 0; i < sortedData.size(); ++i) {
+		y[static_cast<Eigen::Index>(i)] = sortedData[i].second;  // Corresponding value
 	}
 
-	// Step 3: Call the original linear regression function
-	return linearRegression(x, y);
+	// Step 3: The regressor is the chronological index
+	return linearRegressionOnIndex(y);
 }
 
 // Function to calculate p-value given a test statistic and degrees of freedom
@@ -1,31 +1,271 @@
 #include "Stock.hpp"
+#include "PrefixSumIndex.hpp"
+#include <limits>
+
+namespace {
+    const double MISSING_VALUE = std::numeric_limits<double>::quiet_NaN();
+
+    const std::array<std::string, Stock::FIELD_COUNT> FIELD_NAMES = {
+        "open", "high", "low", "close", "adj close", "volume"
+    };
+}
 
 // Add a data entry for a specific date
 void Stock::addData(const std::string& date, const std::string& key, double value) {
-    historicalData[date][key] = value;
+    Date parsed;
+    if (!Date::parse(date, parsed)) {
+        undatedData[date][key] = value;
+        invalidateViews();
+        return;
+    }
+    std::size_t row = insertDate(parsed);
+
+    Field field;
+    if (parseField(key, field)) {
+        columns[static_cast<std::size_t>(field)][row] = value;
+    } else {
+        auto it = extraColumns.find(key);
+        if (it == extraColumns.end()) {
+            it = extraColumns.emplace(key, Column(dates.size(), MISSING_VALUE)).first;
+        }
+        it->second[row] = value;
+    }
+    invalidateViews();
 }
 
 // Retrieve data for a specific date and key
 double Stock::getData(const std::string& date, const std::string& key) const {
-    if (historicalData.count(date) && historicalData.at(date).count(key)) {
-        return historicalData.at(date).at(key);
+    std::size_t row = findDate(date);
+    if (row != npos) {
+        Field field;
+        double value = MISSING_VALUE;
+        if (parseField(key, field)) {
+            value = columns[static_cast<std::size_t>(field)][row];
+        } else {
+            auto it = extraColumns.find(key);
+            if (it != extraColumns.end()) value = it->second[row];
+        }
+        if (!std::isnan(value)) return value;
     } else {
-        std::cerr << "Data not found for date: " << date << " and key: " << key << std::endl;
-        return 0.0; // Or throw an exception if preferred
+        auto entry = undatedData.find(date);
+        if (entry != undatedData.end()) {
+            auto it = entry->second.find(key);
+            if (it != entry->second.end()) return it->second;
+        }
     }
+    std::cerr << "Data not found for date: " << date << " and key: " << key << std::endl;
+    return 0.0; // Or throw an exception if preferred
 }
 
 // Print all historical data
 void Stock::printHistoricalData() const {
-    for (const auto& dateEntry : historicalData) {
-        std::cout << "Date: " << dateEntry.first << "\n";
-        for (const auto& dataEntry : dateEntry.second) {
-            std::cout << "  " << dataEntry.first << ": " << dataEntry.second << "\n";
+    for (std::size_t row = 0; row < dates.size(); ++row) {
+        std::cout << "Date: " << dates[row].toString() << "\n";
+        for (std::size_t f = 0; f < FIELD_COUNT; ++f) {
+            if (!std::isnan(columns[f][row])) {
+                std::cout << "  " << FIELD_NAMES[f] << ": " << columns[f][row] << "\n";
+            }
+        }
+        for (const auto& [key, column] : extraColumns) {
+            if (!std::isnan(column[row])) {
+                std::cout << "  " << key << ": " << column[row] << "\n";
+            }
+        }
+    }
+    for (const auto& [date, dataMap] : undatedData) {
+        std::cout << "Date: " << date << "\n";
+        for (const auto& [key, value] : dataMap) {
+            std::cout << "  " << key << ": " << value << "\n";
         }
     }
 }
 
 // Retrieve all historical data
-const Stock::HistoricalData& Stock::getHistoricalData() const {
-    return historicalData;
-}
\ No newline at end of file
+std::shared_ptr<const Stock::HistoricalData> Stock::getHistoricalData() const {
+    auto view = std::atomic_load(&historicalDataView);
+    if (view) return view;
+
+    auto built = std::make_shared<HistoricalData>(undatedData);
+    built->reserve(dates.size() + undatedData.size());
+    for (std::size_t row = 0; row < dates.size(); ++row) {
+        DataMap& dataMap = (*built)[dates[row].toString()];
+        for (std::size_t f = 0; f < FIELD_COUNT; ++f) {
+            if (!std::isnan(columns[f][row])) dataMap[FIELD_NAMES[f]] = columns[f][row];
+        }
+        for (const auto& [key, column] : extraColumns) {
+            if (!std::isnan(column[row])) dataMap[key] = column[row];
+        }
+    }
+
+    // Another thread may have published its view first; keep whichever won so every caller sees the same view
+    std::shared_ptr<const HistoricalData> expected;
+    if (std::atomic_compare_exchange_strong(&historicalDataView, &expected,
+                                            std::shared_ptr<const HistoricalData>(built))) {
+        return built;
+    }
+    return expected;
+}
+
+// Retrieve the prefix sums over the columns
+std::shared_ptr<const PrefixSumIndex> Stock::getPrefixSums() const {
+    auto index = std::atomic_load(&prefixSums);
+    if (index) return index;
+
+    auto built = std::make_shared<const PrefixSumIndex>(*this);
+    std::shared_ptr<const PrefixSumIndex> expected;
+    if (std::atomic_compare_exchange_strong(&prefixSums, &expected, built)) {
+        return built;
+    }
+    return expected;
+}
+
+// Reserve capacity for a number of trading days
+void Stock::reserve(std::size_t rows) {
+    dates.reserve(rows);
+    for (auto& column : columns) column.reserve(rows);
+}
+
+// Append a full row of data for a date
+void Stock::appendRow(Date date, double open, double high, double low,
+                      double close, double adjClose, double volume) {
+    std::size_t row;
+    if (dates.empty() || dates.back() < date) {
+        row = dates.size();
+        dates.push_back(date);
+        for (auto& column : columns) column.push_back(MISSING_VALUE);
+        for (auto& [key, column] : extraColumns) column.push_back(MISSING_VALUE);
+    } else {
+        row = insertDate(date);
+    }
+
+    columns[static_cast<std::size_t>(Field::Open)][row] = open;
+    columns[static_cast<std::size_t>(Field::High)][row] = high;
+    columns[static_cast<std::size_t>(Field::Low)][row] = low;
+    columns[static_cast<std::size_t>(Field::Close)][row] = close;
+    columns[static_cast<std::size_t>(Field::AdjClose)][row] = adjClose;
+    columns[static_cast<std::size_t>(Field::Volume)][row] = volume;
+    invalidateViews();
+}
+
+// Replace all data with prebuilt columns
+void Stock::assignColumns(std::vector<Date>&& newDates, Columns&& newColumns) {
+    for (const auto& column : newColumns) {
+        if (column.size() != newDates.size()) {
+            throw std::invalid_argument("Column length does not match the number of dates.");
+        }
+    }
+
+    // Files are normally in date order; only pay for sorting when they are not
+    bool strictlySorted = std::adjacent_find(newDates.begin(), newDates.end(),
+        [](Date a, Date b) { return !(a < b); }) == newDates.end();
+
+    if (strictlySorted) {
+        dates = std::move(newDates);
+        columns = std::move(newColumns);
+    } else {
+        // Stable sort keeps the last occurrence of a duplicated date, matching repeated addData calls
+        std::vector<std::size_t> order(newDates.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(),
+                         [&newDates](std::size_t a, std::size_t b) { return newDates[a] < newDates[b]; });
+
+        dates.clear();
+        for (auto& column : columns) column.clear();
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            std::size_t src = order[i];
+            bool lastOfDate = i + 1 == order.size() || newDates[order[i + 1]] != newDates[src];
+            if (!lastOfDate) continue;
+            dates.push_back(newDates[src]);
+            for (std::size_t f = 0; f < FIELD_COUNT; ++f) columns[f].push_back(newColumns[f][src]);
+        }
+    }
+    extraColumns.clear();
+    undatedData.clear();
+    invalidateViews();
+}
+
+// Remove all data
+void Stock::clear() {
+    dates.clear();
+    for (auto& column : columns) column.clear();
+    extraColumns.clear();
+    undatedData.clear();
+    invalidateViews();
+}
+
+std::size_t Stock::size() const { return dates.size(); }
+bool Stock::empty() const { return dates.empty() && undatedData.empty(); }
+
+// Approximate heap memory held by the data
+std::size_t Stock::memoryUsage() const {
+    std::size_t bytes = sizeof(Stock) + dates.capacity() * sizeof(Date);
+    for (const auto& column : columns) bytes += column.capacity() * sizeof(double);
+    for (const auto& [key, column] : extraColumns) bytes += key.capacity() + column.capacity() * sizeof(double);
+    for (const auto& [date, dataMap] : undatedData) {
+        bytes += date.capacity() + dataMap.size() * (sizeof(std::string) + sizeof(double));
+    }
+    return bytes;
+}
+
+const std::vector<Date>& Stock::getDates() const { return dates; }
+
+const Stock::Column& Stock::getColumn(Field field) const {
+    return columns[static_cast<std::size_t>(field)];
+}
+
+// Find the row holding a date via binary search
+std::size_t Stock::findDate(Date date) const {
+    auto it = std::lower_bound(dates.begin(), dates.end(), date);
+    if (it == dates.end() || *it != date) return npos;
+    return static_cast<std::size_t>(it - dates.begin());
+}
+
+std::size_t Stock::findDate(const std::string& date) const {
+    Date parsed;
+    if (!Date::parse(date, parsed)) return npos;
+    return findDate(parsed);
+}
+
+// Find the half-open row range of dates within [startDate, endDate]
+std::pair<std::size_t, std::size_t> Stock::getRange(Date startDate, Date endDate) const {
+    auto first = std::lower_bound(dates.begin(), dates.end(), startDate);
+    auto last = std::upper_bound(first, dates.end(), endDate);
+    return {static_cast<std::size_t>(first - dates.begin()), static_cast<std::size_t>(last - dates.begin())};
+}
+
+std::pair<std::size_t, std::size_t> Stock::getRange(const std::string& startDate, const std::string& endDate) const {
+    return getRange(Date::parse(startDate), Date::parse(endDate));
+}
+
+// Map a field name onto its column
+bool Stock::parseField(const std::string& name, Field& field) {
+    for (std::size_t f = 0; f < FIELD_COUNT; ++f) {
+        if (FIELD_NAMES[f] == name) {
+            field = static_cast<Field>(f);
+            return true;
+        }
+    }
+    return false;
+}
+
+const std::string& Stock::fieldName(Field field) {
+    return FIELD_NAMES[static_cast<std::size_t>(field)];
+}
+
+// Helper function to find or insert the row for a date, keeping the date axis sorted
+std::size_t Stock::insertDate(Date date) {
+    auto it = std::lower_bound(dates.begin(), dates.end(), date);
+    std::size_t row = static_cast<std::size_t>(it - dates.begin());
+    if (it != dates.end() && *it == date) return row;
+
+    dates.insert(it, date);
+    for (auto& column : columns) column.insert(column.begin() + row, MISSING_VALUE);
+    for (auto& [key, column] : extraColumns) column.insert(column.begin() + row, MISSING_VALUE);
+    return row;
+}
+
+// Helper function to drop derived views after the data changes
+void Stock::invalidateViews() {
+    std::atomic_store(&historicalDataView, std::shared_ptr<const HistoricalData>());
+    std::atomic_store(&prefixSums, std::shared_ptr<const PrefixSumIndex>());
+}
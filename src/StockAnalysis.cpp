@@ -1,5 +1,53 @@
 #include "StockAnalysis.hpp"
 #include "FileReader.hpp"
+#include "PrefixSumIndex.hpp"
+
+namespace {
+    // Helper functions keeping the map-based calculations for dictionaries whose keys are not all YYYY-MM-DD dates;
+    // keys are compared as strings, as they always were
+    std::unordered_map<std::string, double> differenceByKey(
+        const std::unordered_map<std::string, double>& data1, const std::unordered_map<std::string, double>& data2) {
+        std::unordered_map<std::string, double> difference;
+        for (const auto& [key, value] : data1) {
+            auto it = data2.find(key);
+            if (it == data2.end()) {
+                throw std::invalid_argument("Data dictionaries do not have identical dates.");
+            }
+            difference[key] = value - it->second;
+        }
+        return difference;
+    }
+
+    // Value of the lexicographically earliest key
+    double earliestValue(const std::unordered_map<std::string, double>& data) {
+        return std::min_element(data.begin(), data.end(),
+                                [](const auto& a, const auto& b) { return a.first < b.first; })->second;
+    }
+
+    // Helper function to apply an operation to one value; invalid results and exceptions give 0
+    double applyOperation(double value, const std::function<double(double)>& operation) {
+        try {
+            // Attempt to apply the operation
+            double operatedValue = operation(value);
+
+            // Check for invalid results (e.g., NaN, infinity)
+            if (std::isnan(operatedValue) || std::isinf(operatedValue)) {
+                operatedValue = 0.0; // Set invalid results to 0
+            }
+
+            return operatedValue;
+        } catch (...) {
+            // Catch any exceptions and set the value to 0
+            return 0.0;
+        }
+    }
+
+    std::unordered_map<std::string, double> divideByKey(const std::unordered_map<std::string, double>& data, double baseValue) {
+        std::unordered_map<std::string, double> result;
+        for (const auto& [key, value] : data) result[key] = value / baseValue;
+        return result;
+    }
+}
 
 // Initialize the static cache
 std::unordered_map<const std::unordered_map<std::string, double>*, std::pair<double, double>> StockAnalysis::statisticsCache;
@@ -51,6 +99,14 @@ std::pair<double, double> StockAnalysis::calculateStatistics(const std::unordere
     return {mean, stdDev};
 }
 
+// Method to calculate the mean and population standard deviation of a contiguous series
+std::pair<double, double> StockAnalysis::calculateStatistics(const Eigen::Ref<const Eigen::VectorXd>& data) {
+    const double n = static_cast<double>(data.size());
+    double mean = data.sum() / n;
+    double variance = (data.array() - mean).square().sum() / n;
+    return {mean, std::sqrt(variance)};
+}
+
 // Method to calculate the difference between two stocks within the same date range for a given price type
 std::unordered_map<std::string, double> StockAnalysis::calculateDifference(
     const Stock& stock1, const Stock& stock2, const std::string& priceType, 
@@ -81,40 +137,59 @@ std::unordered_map<std::string, double> StockAnalysis::calculateDifferenceBetwee
     const std::unordered_map<std::string, double>& data1,
     const std::unordered_map<std::string, double>& data2
 ) {
-    std::unordered_map<std::string, double> difference;
+    Series series1, series2;
+    if (!StockUtils::tryToSeries(data1, series1) || !StockUtils::tryToSeries(data2, series2)) {
+        return differenceByKey(data1, data2);
+    }
+    return StockUtils::toMap(calculateDifferenceBetweenData(series1, series2, series1));
+}
 
-    for (const auto& entry : data1) {
-        const auto& date = entry.first;
-        double value1 = entry.second;
-
-        // Ensure the date exists in both dictionaries
-        auto it = data2.find(date);
-        if (it != data2.end()) {
-            double value2 = it->second;
-            difference[date] = value1 - value2;
-        } else {
+// Calculate the difference between two date-sorted series, on the dates of the first one
+SeriesView StockAnalysis::calculateDifferenceBetweenData(SeriesView data1, SeriesView data2, Series& out) {
+    out.assign(data1);
+    std::vector<double>& values = out.getValues();
+
+    // Both axes are sorted, so a single forward walk over data2 finds every date of data1
+    std::size_t j = 0;
+    for (std::size_t i = 0; i < data1.size(); ++i) {
+        Date date = data1.dateAt(i);
+        while (j < data2.size() && data2.dateAt(j) < date) j++;
+
+        // Ensure the date exists in both series
+        if (j == data2.size() || data2.dateAt(j) != date) {
             throw std::invalid_argument("Data dictionaries do not have identical dates.");
         }
+        values[i] -= data2.valueAt(j);
     }
 
-    return difference;
+    return out.view();
 }
 
 // Normalize the values of a dictionary to the value corresponding to the earliest date
 std::unordered_map<std::string, double> StockAnalysis::normalizeToEarliestDate(
     const std::unordered_map<std::string, double>& data
 ) {
+    Series series;
+    if (!StockUtils::tryToSeries(data, series)) {
+        if (data.empty()) {
+            throw std::invalid_argument("Data dictionary is empty.");
+        }
+        double baseValue = earliestValue(data);
+        if (baseValue == 0) {
+            throw std::runtime_error("The price value on the earliest date is zero, cannot normalize.");
+        }
+        return divideByKey(data, baseValue);
+    }
+    return StockUtils::toMap(normalizeToEarliestDate(series, series));
+}
+
+// Normalize a date-sorted series to its first value
+SeriesView StockAnalysis::normalizeToEarliestDate(SeriesView data, Series& out) {
     if (data.empty()) {
         throw std::invalid_argument("Data dictionary is empty.");
     }
 
-    // Find the earliest date in the dictionary
-    auto earliestEntry = std::min_element(data.begin(), data.end(),
-                                          [](const auto& a, const auto& b) {
-                                              return a.first < b.first; // Lexicographical comparison of dates
-                                          });
-
-    double baseValue = earliestEntry->second;
+    double baseValue = data.valueAt(0);
 
     // Check if the base value is non-zero to prevent division by zero
     if (baseValue == 0) {
@@ -122,12 +197,12 @@ std::unordered_map<std::string, double> StockAnalysis::normalizeToEarliestDate(
     }
 
     // Normalize each value by dividing by the base value
-    std::unordered_map<std::string, double> normalizedData;
-    for (const auto& entry : data) {
-        normalizedData[entry.first] = entry.second / baseValue;
+    out.assign(data);
+    for (double& value : out.getValues()) {
+        value /= baseValue;
     }
 
-    return normalizedData;
+    return out.view();
 }
 
 // Check if a Stock object has valid data within a specified date range
@@ -135,31 +210,67 @@ bool StockAnalysis::hasValidDataInRange(
     const Stock& stock1, const Stock& stock2, const std::string& priceType,
     const std::string& startDate, const std::string& endDate
 ) {
-    // Retrieve data for the specified price type within the date range for both stocks
-    auto data1 = StockUtils::getPriceDataInRange(stock1, priceType, startDate, endDate);
-    auto data2 = StockUtils::getPriceDataInRange(stock2, priceType, startDate, endDate);
+    std::string failureReason;
+    if (!hasValidDataInRange(stock1, stock2, priceType, startDate, endDate, &failureReason)) {
+        std::cout << failureReason << "\n";
+        return false;
+    }
+    return true;
+}
+
+// Check if a Stock object has valid data within a specified date range, reporting why it does not
+bool StockAnalysis::hasValidDataInRange(
+    const Stock& stock1, const Stock& stock2, const std::string& priceType,
+    const std::string& startDate, const std::string& endDate, std::string* failureReason
+) {
+    Stock::Field field;
+    if (!Stock::parseField(priceType, field)) {
+        if (failureReason) *failureReason = "One of the stocks has no data in the specified range.";
+        return false;
+    }
+
+    // Locate the specified date range in both stocks; dates are compared as day numbers
+    auto [first1, last1] = stock1.getRange(startDate, endDate);
+    auto [first2, last2] = stock2.getRange(startDate, endDate);
+    const auto& dates1 = stock1.getDates();
+    const auto& dates2 = stock2.getDates();
+    const auto& values1 = stock1.getColumn(field);
+    const auto& values2 = stock2.getColumn(field);
+
+    auto countValid = [](const Stock::Column& values, std::size_t first, std::size_t last) {
+        std::size_t count = 0;
+        for (std::size_t row = first; row < last; ++row) {
+            if (!std::isnan(values[row])) count++;
+        }
+        return count;
+    };
+    std::size_t size1 = countValid(values1, first1, last1);
+    std::size_t size2 = countValid(values2, first2, last2);
 
     // If either stock has no data in the specified range, return false
-    if (data1.empty() || data2.empty()) {
-        std::cout << "One of the stocks has no data in the specified range.\n";
+    if (size1 == 0 || size2 == 0) {
+        if (failureReason) *failureReason = "One of the stocks has no data in the specified range.";
         return false;
     }
 
     // Compare dates in both datasets
-    if (data1.size() != data2.size()) {
-        std::cout << "The stocks have a different number of dates in the specified range.\n";
+    if (size1 != size2) {
+        if (failureReason) *failureReason = "The stocks have a different number of dates in the specified range.";
         return false;
     }
 
-    for (const auto& entry : data1) {
-        const std::string& date = entry.first;
-        auto it2 = data2.find(date);
+    // With equal counts, both sorted date sequences must match one to one
+    std::size_t row2 = first2;
+    for (std::size_t row1 = first1; row1 < last1; ++row1) {
+        if (std::isnan(values1[row1])) continue;
+        while (std::isnan(values2[row2])) row2++;
 
         // Check if the date exists in both datasets and has valid (non-zero) data
-        if (it2 == data2.end() || entry.second == 0 || it2->second == 0) {
-            std::cout << "Mismatch or invalid data on date: " << date << "\n";
+        if (dates1[row1] != dates2[row2] || values1[row1] == 0 || values2[row2] == 0) {
+            if (failureReason) *failureReason = "Mismatch or invalid data on date: " + dates1[row1].toString();
             return false;
         }
+        row2++;
     }
 
     return true;
@@ -167,48 +278,30 @@ bool StockAnalysis::hasValidDataInRange(
 
 // Calculate the price-volume for a given date and price type
 double StockAnalysis::calculatePriceVolume(const Stock& stock, const std::string& date, const std::string& priceType) {
-    // Retrieve historical data from the stock
-    const auto& historicalData = stock.getHistoricalData();
-
     // Check if the specified date exists in historical data
-    auto dateIt = historicalData.find(date);
-    if (dateIt == historicalData.end()) {
+    std::size_t row = stock.findDate(date);
+    if (row == Stock::npos) {
         throw std::invalid_argument("No data available for the specified date: " + date);
     }
 
     // Retrieve the price and volume for the given date
-    const auto& dataMap = dateIt->second;
-    auto priceIt = dataMap.find(priceType);
-    auto volumeIt = dataMap.find("volume");
+    Stock::Field priceField;
+    double price = std::nan("");
+    if (Stock::parseField(priceType, priceField)) {
+        price = stock.getColumn(priceField)[row];
+    }
+    double volume = stock.getColumn(Stock::Field::Volume)[row];
 
     // Ensure both price and volume are available
-    if (priceIt == dataMap.end()) {
+    if (std::isnan(price)) {
         throw std::invalid_argument("No price data found for type: " + priceType + " on date: " + date);
     }
-    if (volumeIt == dataMap.end()) {
+    if (std::isnan(volume)) {
         throw std::invalid_argument("No volume data found on date: " + date);
     }
 
     // Calculate and return the price-volume product
-    return priceIt->second * volumeIt->second;
-}
-
-// Helper function to increment a date by one day
-std::string incrementDate(const std::string& dateStr) {
-    std::tm tm = {};
-    std::istringstream ss(dateStr);
-    ss >> std::get_time(&tm, "%Y-%m-%d");
-
-    // Increment the day by one
-    tm.tm_mday += 1;
-
-    // Normalize the time structure, handling month and year transitions
-    std::mktime(&tm);
-
-    // Convert back to string in YYYY-MM-DD format
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y-%m-%d");
-    return oss.str();
+    return price * volume;
 }
 
 // Calculate the average price-volume of a stock within a specified date range
@@ -216,28 +309,29 @@ double StockAnalysis::calculateAveragePriceVolume(
     const Stock& stock, const std::string& priceType, const std::string& startDate,
 	const std::string& endDate
 ) {
-    double totalPriceVolume = 0.0;
-    int validDateCount = 0;
-
-    // Loop through each date in the range
-    std::string currentDate = startDate;
-    while (currentDate <= endDate) {
-        try {
-            // Attempt to calculate price-volume for the current date
-            double priceVolume = calculatePriceVolume(stock, currentDate, priceType);
-            totalPriceVolume += priceVolume;
-            validDateCount++;
-        } catch (const std::exception& e) {
-            // Ignore dates with missing data or other issues
+    // Answer from the stock's prefix sums: two binary searches for the range bounds, then O(1)
+    Stock::Field priceField;
+    PrefixSumIndex::RangeSummary summary;
+    if (Stock::parseField(priceType, priceField)) {
+        summary = stock.getPrefixSums()->summarizePriceVolume(priceField, Date::parse(startDate), Date::parse(endDate));
+    } else {
+        // Keys outside the OHLCV set only live in the compatibility view; walk the days of the range in it
+        std::shared_ptr<const Stock::HistoricalData> historicalData = stock.getHistoricalData();
+        auto [firstRow, lastRow] = stock.getRange(startDate, endDate);
+        for (std::size_t row = firstRow; row < lastRow; ++row) {
+            const Stock::DataMap& dataMap = historicalData->at(stock.getDates()[row].toString());
+            auto priceIt = dataMap.find(priceType);
+            auto volumeIt = dataMap.find("volume");
+            if (priceIt != dataMap.end() && volumeIt != dataMap.end()) {
+                summary.sum += priceIt->second * volumeIt->second;
+                summary.count++;
+            }
         }
-
-        // Move to the next date
-        currentDate = incrementDate(currentDate);
     }
 
     // Calculate the average if there are valid dates; otherwise, return 0
-    if (validDateCount > 0) {
-        return totalPriceVolume / validDateCount;
+    if (summary.count > 0) {
+        return summary.sum / static_cast<double>(summary.count);
     } else {
         throw std::runtime_error("No valid price-volume data found within the specified date range.");
     }
@@ -290,6 +384,52 @@ double StockAnalysis::calculatePValueForURT(
         prices[i] = sortedData[i].second;
     }
 
+    return runUnitRootTest(prices, testType, lags, trend, method, lagLength);
+}
+
+double StockAnalysis::calculatePValueForURT(
+    const Eigen::Ref<const Eigen::VectorXd>& series,
+    const std::string& testType, int lags, const std::string& trend,
+    const std::string& method, const std::string& lagLength) {
+
+    if (series.size() == 0) {
+        throw std::invalid_argument("Input data is empty.");
+    }
+
+    // URT takes its own vector type
+    const Eigen::VectorXd prices = series;
+    return runUnitRootTest(prices, testType, lags, trend, method, lagLength);
+}
+
+// Run the unit-root battery on one series
+StockAnalysis::UnitRootPValues StockAnalysis::calculateUnitRootBattery(
+    const Eigen::Ref<const Eigen::VectorXd>& series, int lags, const std::string& trend) {
+
+    if (series.size() == 0) {
+        throw std::invalid_argument("Input data is empty.");
+    }
+
+    // Convert once; every test reads the same vector
+    const Eigen::VectorXd prices = series;
+
+    UnitRootPValues pValues;
+    pValues.adfAIC = runUnitRootTest(prices, "ADF", lags, trend, "AIC", "");
+    pValues.adfBIC = runUnitRootTest(prices, "ADF", lags, trend, "BIC", "");
+    pValues.ppShortRho = runUnitRootTest(prices, "PP", lags, trend, "rho", "short");
+    pValues.ppLongRho = runUnitRootTest(prices, "PP", lags, trend, "rho", "long");
+    pValues.ppShortTau = runUnitRootTest(prices, "PP", lags, trend, "tau", "short");
+    pValues.ppLongTau = runUnitRootTest(prices, "PP", lags, trend, "tau", "long");
+    pValues.kpssShort = runUnitRootTest(prices, "KPSS", lags, trend, "", "short");
+    pValues.kpssLong = runUnitRootTest(prices, "KPSS", lags, trend, "", "long");
+    return pValues;
+}
+
+// Helper running one unit-root test
+double StockAnalysis::runUnitRootTest(
+    const Eigen::VectorXd& prices,
+    const std::string& testType, int lags, const std::string& trend,
+    const std::string& method, const std::string& lagLength) {
+
     // Select the appropriate test type and calculate the p-value
     double pValue = 0.0;
 
@@ -340,35 +480,44 @@ std::string StockAnalysis::makeCacheKey(const std::string& stock1, const std::st
 	return stock1 < stock2 ? stock1 + "-" + stock2 : stock2 + "-" + stock1;
 }
 
+// Normalize data to the earliest value of some other reference data
 std::unordered_map<std::string, double> StockAnalysis::normalizeToReferenceData(
     const std::unordered_map<std::string, double>& dataToNormalize,
     const std::unordered_map<std::string, double>& referenceData) {
 
+    Series series, reference;
+    if (!StockUtils::tryToSeries(dataToNormalize, series) || !StockUtils::tryToSeries(referenceData, reference)) {
+        if (referenceData.empty()) {
+            throw std::invalid_argument("Reference data is empty.");
+        }
+        double baseValue = earliestValue(referenceData);
+        if (baseValue == 0) {
+            throw std::runtime_error("The price value on the reference earliest date is zero, cannot normalize.");
+        }
+        return divideByKey(dataToNormalize, baseValue);
+    }
+    return StockUtils::toMap(normalizeToReferenceData(series, reference, series));
+}
+
+// Normalize a series to the first value of a date-sorted reference series
+SeriesView StockAnalysis::normalizeToReferenceData(SeriesView dataToNormalize, SeriesView referenceData, Series& out) {
     if (referenceData.empty()) {
         throw std::invalid_argument("Reference data is empty.");
     }
-    
-	// Find the earliest date in the reference data
-    auto earliestEntry = std::min_element(referenceData.begin(), referenceData.end(),
-                                          [](const auto& a, const auto& b) {
-                                              return a.first < b.first; // Lexicographical comparison of dates
-                                          });
-
-    const std::string& earliestDate = earliestEntry->first;
 
     // Check if the base value is non-zero to prevent division by zero
-    double baseValue = earliestEntry->second;
+    double baseValue = referenceData.valueAt(0);
     if (baseValue == 0) {
         throw std::runtime_error("The price value on the reference earliest date is zero, cannot normalize.");
     }
 
     // Normalize the dataToNormalize based on the base value
-    std::unordered_map<std::string, double> normalizedData;
-    for (const auto& entry : dataToNormalize) {
-        normalizedData[entry.first] = entry.second / baseValue;
+    out.assign(dataToNormalize);
+    for (double& value : out.getValues()) {
+        value /= baseValue;
     }
 
-    return normalizedData;
+    return out.view();
 }
 
 // Function to apply a mathematical operation to values in a map
@@ -376,28 +525,28 @@ std::unordered_map<std::string, double> StockAnalysis::applyMapOperation(
 	const std::unordered_map<std::string, double>& data,
 	const std::function<double(double)>& operation
 ) {
+	// The operation does not look at the keys, so any dictionary is mapped value by value
 	std::unordered_map<std::string, double> result;
-
+	result.reserve(data.size());
 	for (const auto& [key, value] : data) {
-		try {
-			// Attempt to apply the operation
-			double operatedValue = operation(value);
-
-			// Check for invalid results (e.g., NaN, infinity)
-			if (std::isnan(operatedValue) || std::isinf(operatedValue)) {
-				operatedValue = 0.0; // Set invalid results to 0
-			}
-
-			result[key] = operatedValue;
-		} catch (...) {
-			// Catch any exceptions and set the value to 0
-			result[key] = 0.0;
-		}
+		result[key] = applyOperation(value, operation);
 	}
-
 	return result;
 }
 
+// Function to apply a mathematical operation to the values of a series
+SeriesView StockAnalysis::applyMapOperation(
+	SeriesView data, const std::function<double(double)>& operation, Series& out
+) {
+	out.assign(data);
+
+	for (double& value : out.getValues()) {
+		value = applyOperation(value, operation);
+	}
+
+	return out.view();
+}
+
 // Method to clear the cache
 void StockAnalysis::clearCache(){
 	statisticsCache.clear();
@@ -0,0 +1,213 @@
+#include "StockDataCache.hpp"
+#include "Config.hpp"
+#include "MappedFile.hpp"
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+namespace {
+    std::uint64_t alignUp(std::uint64_t value) {
+        return (value + StockDataCache::BLOCK_ALIGNMENT - 1) / StockDataCache::BLOCK_ALIGNMENT * StockDataCache::BLOCK_ALIGNMENT;
+    }
+
+    // Helper function to write zero padding up to an aligned offset
+    void padTo(std::ofstream& file, std::uint64_t& offset, std::uint64_t target) {
+        static const char zeros[StockDataCache::BLOCK_ALIGNMENT] = {};
+        file.write(zeros, static_cast<std::streamsize>(target - offset));
+        offset = target;
+    }
+
+    // Helper function to check that count values of the given width starting at offset lie within a file of fileSize bytes
+    bool fitsArray(std::uint64_t offset, std::uint64_t count, std::uint64_t width, std::uint64_t fileSize) {
+        return offset <= fileSize && count <= (fileSize - offset) / width;
+    }
+}
+
+constexpr char StockDataCache::MAGIC[8];
+
+// Derive the cache file path for a source file
+std::string StockDataCache::getCachePath(const std::string& sourceFile) {
+    return sourceFile + Config::CACHE_FILE_EXTENSION;
+}
+
+// Check whether an up-to-date cache exists for a source file
+bool StockDataCache::isFresh(const std::string& sourceFile) {
+    std::uint64_t sourceSize;
+    std::int64_t sourceModifiedTime;
+    if (!getSourceStamp(sourceFile, sourceSize, sourceModifiedTime)) return false;
+
+    std::ifstream file(getCachePath(sourceFile), std::ios::binary);
+    Header header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+
+    return std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+           header.version == FORMAT_VERSION &&
+           header.byteOrderMark == BYTE_ORDER_MARK &&
+           header.sourceSize == sourceSize &&
+           header.sourceModifiedTime == sourceModifiedTime;
+}
+
+// Read the cache of a source file into column buffers
+bool StockDataCache::load(const std::string& sourceFile, std::vector<Date>& dates, Stock::Columns& columns,
+                          FileReader::LoadReport& report) {
+    std::uint64_t sourceSize;
+    std::int64_t sourceModifiedTime;
+    if (!getSourceStamp(sourceFile, sourceSize, sourceModifiedTime)) return false;
+
+    MappedFile file(getCachePath(sourceFile));
+    if (!file.isOpen() || file.size() < sizeof(Header)) return false;
+
+    Header header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        header.version != FORMAT_VERSION ||
+        header.byteOrderMark != BYTE_ORDER_MARK ||
+        header.sourceSize != sourceSize ||
+        header.sourceModifiedTime != sourceModifiedTime) {
+        return false;
+    }
+
+    // Reject truncated files before touching the blocks; every test divides rather than multiplies, so a corrupt header
+    // cannot wrap it
+    const std::uint64_t rows = header.rowCount;
+    if (!fitsArray(header.dateBlockOffset, rows, sizeof(std::int32_t), file.size()) ||
+        header.columnBlockOffset > file.size() ||
+        header.columnBlockStride > file.size() / Stock::FIELD_COUNT ||
+        rows > header.columnBlockStride / sizeof(double) ||
+        header.warningSampleCount > FileReader::MAX_WARNING_SAMPLES || header.warningBlockOffset > file.size()) {
+        return false;
+    }
+    // With the offset and stride bounded by the file size, the block offsets below cannot wrap
+    for (std::size_t f = 0; f < Stock::FIELD_COUNT; ++f) {
+        if (!fitsArray(header.columnBlockOffset + f * header.columnBlockStride, rows, sizeof(double), file.size())) {
+            return false;
+        }
+    }
+
+    // Warning sample of the parse the cache was written from, read first so a corrupt block leaves the outputs untouched
+    std::vector<std::string> sampleWarnings;
+    const char* warning = file.data() + header.warningBlockOffset;
+    const char* const end = file.data() + file.size();
+    for (std::uint64_t w = 0; w < header.warningSampleCount; ++w) {
+        std::uint32_t length;
+        if (static_cast<std::size_t>(end - warning) < sizeof(length)) return false;
+        std::memcpy(&length, warning, sizeof(length));
+        warning += sizeof(length);
+        if (static_cast<std::size_t>(end - warning) < length) return false;
+        sampleWarnings.emplace_back(warning, length);
+        warning += length;
+    }
+
+    dates.resize(rows);
+    const char* dateBlock = file.data() + header.dateBlockOffset;
+    for (std::uint64_t row = 0; row < rows; ++row) {
+        std::int32_t dayNumber;
+        std::memcpy(&dayNumber, dateBlock + row * sizeof(dayNumber), sizeof(dayNumber));
+        dates[row] = Date::fromDayNumber(dayNumber);
+    }
+
+    for (std::size_t f = 0; f < Stock::FIELD_COUNT; ++f) {
+        columns[f].resize(rows);
+        if (rows > 0) {
+            std::memcpy(columns[f].data(), file.data() + header.columnBlockOffset + f * header.columnBlockStride,
+                        rows * sizeof(double));
+        }
+    }
+
+    report.linesRead = header.linesRead;
+    report.malformedLines = header.malformedLines;
+    report.invalidFormatLines = header.invalidFormatLines;
+    report.outOfRangeLines = header.outOfRangeLines;
+    report.sampleWarnings = std::move(sampleWarnings);
+    return true;
+}
+
+// Write the cache for a source file from a loaded Stock
+bool StockDataCache::write(const std::string& sourceFile, const Stock& stock, const FileReader::LoadReport& report) {
+    std::uint64_t sourceSize;
+    std::int64_t sourceModifiedTime;
+    if (!getSourceStamp(sourceFile, sourceSize, sourceModifiedTime)) return false;
+
+    const auto& stockDates = stock.getDates();
+    std::vector<std::int32_t> dayNumbers(stockDates.size());
+    for (std::size_t row = 0; row < stockDates.size(); ++row) {
+        dayNumbers[row] = stockDates[row].dayNumber();
+    }
+
+    const std::uint64_t rows = stockDates.size();
+    Header header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = FORMAT_VERSION;
+    header.byteOrderMark = BYTE_ORDER_MARK;
+    header.rowCount = rows;
+    header.sourceSize = sourceSize;
+    header.sourceModifiedTime = sourceModifiedTime;
+    header.dateBlockOffset = alignUp(sizeof(Header));
+    header.columnBlockOffset = alignUp(header.dateBlockOffset + rows * sizeof(std::int32_t));
+    header.columnBlockStride = alignUp(rows * sizeof(double));
+    header.linesRead = report.linesRead;
+    header.malformedLines = report.malformedLines;
+    header.invalidFormatLines = report.invalidFormatLines;
+    header.outOfRangeLines = report.outOfRangeLines;
+    header.warningBlockOffset = header.columnBlockOffset + Stock::FIELD_COUNT * header.columnBlockStride;
+    header.warningSampleCount = std::min<std::uint64_t>(report.sampleWarnings.size(), FileReader::MAX_WARNING_SAMPLES);
+
+    // Write to a private temporary file and rename it into place, so concurrent readers never see a partial cache
+    static std::atomic<unsigned long> temporaryCounter{0};
+    const std::string cachePath = getCachePath(sourceFile);
+    const std::string temporaryPath = cachePath + ".tmp" +
+        std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + "_" + std::to_string(temporaryCounter++);
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file) return false;
+
+        std::uint64_t offset = 0;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        offset += sizeof(header);
+        padTo(file, offset, header.dateBlockOffset);
+
+        file.write(reinterpret_cast<const char*>(dayNumbers.data()), static_cast<std::streamsize>(rows * sizeof(std::int32_t)));
+        offset += rows * sizeof(std::int32_t);
+
+        for (std::size_t f = 0; f < Stock::FIELD_COUNT; ++f) {
+            padTo(file, offset, header.columnBlockOffset + f * header.columnBlockStride);
+            const Stock::Column& column = stock.getColumn(static_cast<Stock::Field>(f));
+            file.write(reinterpret_cast<const char*>(column.data()), static_cast<std::streamsize>(rows * sizeof(double)));
+            offset += rows * sizeof(double);
+        }
+
+        padTo(file, offset, header.warningBlockOffset);
+        for (std::uint64_t w = 0; w < header.warningSampleCount; ++w) {
+            const std::string& warning = report.sampleWarnings[w];
+            const std::uint32_t length = static_cast<std::uint32_t>(warning.size());
+            file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+            file.write(warning.data(), static_cast<std::streamsize>(length));
+        }
+
+        if (!file) {
+            file.close();
+            std::error_code ec;
+            std::filesystem::remove(temporaryPath, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temporaryPath, cachePath, ec);
+    if (ec) {
+        std::filesystem::remove(temporaryPath, ec);
+        return false;
+    }
+    return true;
+}
+
+// Size and modification time of a source file
+bool StockDataCache::getSourceStamp(const std::string& sourceFile, std::uint64_t& size, std::int64_t& modifiedTime) {
+    std::error_code ec;
+    size = std::filesystem::file_size(sourceFile, ec);
+    if (ec) return false;
+    auto writeTime = std::filesystem::last_write_time(sourceFile, ec);
+    if (ec) return false;
+    modifiedTime = static_cast<std::int64_t>(writeTime.time_since_epoch().count());
+    return true;
+}
@@ -0,0 +1,129 @@
+#include "StockDataStore.hpp"
+#include "Config.hpp"
+
+StockDataStore::StockDataStore(std::size_t memoryBudgetBytes)
+    : memoryBudget(memoryBudgetBytes) {}
+
+// Process-wide store
+StockDataStore& StockDataStore::instance() {
+    static StockDataStore store(Config::STORE_MEMORY_BUDGET_BYTES);
+    return store;
+}
+
+// Fetch a stock data file, loading it on first use
+std::shared_ptr<const Stock> StockDataStore::get(const std::string& filename, FileReader::LoadReport* report) {
+    std::promise<StockPointer> loadPromise;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto it = entries.find(filename);
+        if (it != entries.end()) {
+            statistics.hits++;
+            std::shared_future<StockPointer> pending = it->second.stock;
+            if (it->second.ready) {
+                lruOrder.splice(lruOrder.begin(), lruOrder, it->second.lruPosition);
+                if (report) *report = it->second.loadReport;
+                return pending.get();
+            }
+
+            // Another thread is loading this file; wait for it outside the lock
+            lock.unlock();
+            StockPointer stock = pending.get();
+            if (report) {
+                std::lock_guard<std::mutex> relock(mutex);
+                auto loaded = entries.find(filename);
+                *report = loaded != entries.end() ? loaded->second.loadReport : FileReader::LoadReport();
+            }
+            return stock;
+        }
+
+        statistics.misses++;
+        entries[filename].stock = loadPromise.get_future().share();
+    }
+
+    // Load outside the lock so other files can be served meanwhile
+    auto stock = std::make_shared<Stock>();
+    FileReader::LoadReport loadReport;
+    StockPointer result;
+    if (FileReader::loadStockDataFromFile(filename, *stock, loadReport)) {
+        result = std::move(stock);
+    }
+    loadPromise.set_value(result);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    Entry& entry = entries[filename];
+    entry.loadReport = loadReport;
+    entry.bytes = result ? result->memoryUsage() : 0;
+    entry.ready = true;
+    lruOrder.push_front(filename);
+    entry.lruPosition = lruOrder.begin();
+
+    if (!result) statistics.loadFailures++;
+    statistics.bytesResident += entry.bytes;
+    statistics.bytesLoaded += entry.bytes;
+    if (report) *report = loadReport;
+
+    evictToBudget();
+    return result;
+}
+
+std::shared_ptr<const Stock> StockDataStore::get(const std::string& stockDataDir, const std::string& symbol,
+                                                 const std::string& fileExtension, FileReader::LoadReport* report) {
+    return get(stockDataDir + symbol + fileExtension, report);
+}
+
+// Check whether a file is currently resident
+bool StockDataStore::contains(const std::string& filename) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(filename);
+    return it != entries.end() && it->second.ready;
+}
+
+// Change the memory budget
+void StockDataStore::setMemoryBudget(std::size_t memoryBudgetBytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    memoryBudget = memoryBudgetBytes;
+    evictToBudget();
+}
+
+std::size_t StockDataStore::getMemoryBudget() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return memoryBudget;
+}
+
+// Drop every resident entry
+void StockDataStore::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& filename : lruOrder) {
+        auto it = entries.find(filename);
+        statistics.bytesResident -= it->second.bytes;
+        entries.erase(it);
+    }
+    lruOrder.clear();
+}
+
+StockDataStore::Statistics StockDataStore::getStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Statistics snapshot = statistics;
+    snapshot.residentEntries = lruOrder.size();
+    return snapshot;
+}
+
+void StockDataStore::printStatistics(std::ostream& os) const {
+    Statistics snapshot = getStatistics();
+    os << "Stock data store: " << snapshot.hits << " hits, " << snapshot.misses << " misses ("
+       << snapshot.loadFailures << " failed), " << snapshot.evictions << " evictions, "
+       << snapshot.residentEntries << " resident entries, " << snapshot.bytesResident << " bytes resident, "
+       << snapshot.bytesLoaded << " bytes loaded\n";
+}
+
+// Evict least recently used entries until the budget holds; the most recent entry is always kept
+void StockDataStore::evictToBudget() {
+    if (memoryBudget == 0) return;
+    while (statistics.bytesResident > memoryBudget && lruOrder.size() > 1) {
+        auto it = entries.find(lruOrder.back());
+        statistics.bytesResident -= it->second.bytes;
+        statistics.evictions++;
+        entries.erase(it);
+        lruOrder.pop_back();
+    }
+}
@@ -1,48 +1,123 @@
 #include "StockUtils.hpp"
 
+namespace {
+    // Helper function to resolve a price type name into a Stock column
+    const Stock::Column* findColumn(const Stock& stock, const std::string& priceType) {
+        Stock::Field field;
+        if (!Stock::parseField(priceType, field)) return nullptr;
+        return &stock.getColumn(field);
+    }
+
+    // Helper function to copy the rows [first, last) of a column into a date-keyed map
+    std::unordered_map<std::string, double> collectRows(
+        const Stock& stock, const Stock::Column& column, std::size_t first, std::size_t last
+    ) {
+        std::unordered_map<std::string, double> priceData;
+        priceData.reserve(last - first);
+        const auto& dates = stock.getDates();
+        for (std::size_t row = first; row < last; ++row) {
+            if (!std::isnan(column[row])) {
+                priceData.emplace(dates[row].toString(), column[row]);
+            }
+        }
+        return priceData;
+    }
+}
+
 // Method to retrieve just a single value (adj close, close, high, low, open, volume) from Stock object
 std::unordered_map<std::string, double> StockUtils::getPriceData(const Stock& stock, const std::string& priceType) {
-    std::unordered_map<std::string, double> priceData;
-    const auto& historicalData = stock.getHistoricalData();
+    const Stock::Column* column = findColumn(stock, priceType);
+    if (column == nullptr) {
+        // Keys outside the OHLCV set only live in the compatibility view
+        std::unordered_map<std::string, double> priceData;
+        std::shared_ptr<const Stock::HistoricalData> historicalData = stock.getHistoricalData();
+        for (const auto& [date, dataMap] : *historicalData) {
+            auto it = dataMap.find(priceType);
+            if (it != dataMap.end()) priceData[date] = it->second;
+        }
+        return priceData;
+    }
 
-    for (const auto& dateEntry : historicalData) {
-        const auto& date = dateEntry.first;
-        const auto& dataMap = dateEntry.second;
+    return collectRows(stock, *column, 0, stock.size());
+}
 
-        auto it = dataMap.find(priceType);
-        if (it != dataMap.end()) {
-            priceData[date] = it->second;
+// Method to retrieve a price type (adj close, close, high, low, open, volume) from Stock object within a date range
+std::unordered_map<std::string, double> StockUtils::getPriceDataInRange(
+    const Stock& stock, const std::string& priceType, const std::string& startDate, const std::string& endDate
+) {
+    const Stock::Column* column = findColumn(stock, priceType);
+    if (column == nullptr) {
+        std::unordered_map<std::string, double> priceData;
+        std::shared_ptr<const Stock::HistoricalData> historicalData = stock.getHistoricalData();
+        for (const auto& [date, dataMap] : *historicalData) {
+            auto it = dataMap.find(priceType);
+            if (date >= startDate && date <= endDate && it != dataMap.end()) priceData[date] = it->second;
         }
+        return priceData;
     }
 
-    return priceData;
+    // Binary search for the bounds of the range on the sorted date axis
+    auto [first, last] = stock.getRange(startDate, endDate);
+    return collectRows(stock, *column, first, last);
 }
 
-// Helper function to check if a date is within the specified range
-bool isDateInRange(const std::string& date, const std::string& startDate, const std::string& endDate) {
-    return date >= startDate && date <= endDate;
+// Method to view a column within a date range without copying
+SeriesView StockUtils::getPriceSeriesInRange(const Stock& stock, Stock::Field field, Date startDate, Date endDate) {
+    auto [first, last] = stock.getRange(startDate, endDate);
+    return SeriesView(stock.getDates().data() + first, stock.getColumn(field).data() + first, last - first);
 }
 
-// Method to retrieve a price type (adj close, close, high, low, open, volume) from Stock object within a date range
-std::unordered_map<std::string, double> StockUtils::getPriceDataInRange(
-    const Stock& stock, const std::string& priceType, const std::string& startDate, const std::string& endDate
+// Method to copy the valid values of a price type within a date range into a buffer
+SeriesView StockUtils::getPriceSeriesInRange(
+    const Stock& stock, const std::string& priceType, const std::string& startDate, const std::string& endDate,
+    Series& out
 ) {
-    std::unordered_map<std::string, double> priceData;
-    const auto& historicalData = stock.getHistoricalData();
+    Stock::Field field;
+    if (!Stock::parseField(priceType, field)) {
+        return toSeries(getPriceDataInRange(stock, priceType, startDate, endDate), out);
+    }
 
-    for (const auto& dateEntry : historicalData) {
-        const auto& date = dateEntry.first;
+    SeriesView rows = getPriceSeriesInRange(stock, field, Date::parse(startDate), Date::parse(endDate));
+    out.clear();
+    out.reserve(rows.size());
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        if (!std::isnan(rows.valueAt(i))) out.push_back(rows.dateAt(i), rows.valueAt(i));
+    }
+    return out.view();
+}
 
-        // Check if the date falls within the specified range
-        if (isDateInRange(date, startDate, endDate)) {
-            const auto& dataMap = dateEntry.second;
+// Method to convert a date-keyed dictionary into a date-sorted series
+SeriesView StockUtils::toSeries(const std::unordered_map<std::string, double>& data, Series& out) {
+    if (!tryToSeries(data, out)) {
+        for (const auto& entry : data) Date::parse(entry.first); // Throws for the first key that is not a date
+    }
+    return out.view();
+}
 
-            auto it = dataMap.find(priceType);
-            if (it != dataMap.end()) {
-                priceData[date] = it->second;
-            }
-        }
+// Method to convert a date-keyed dictionary into a date-sorted series, if every key is a date
+bool StockUtils::tryToSeries(const std::unordered_map<std::string, double>& data, Series& out) {
+    std::vector<std::pair<Date, double>> entries;
+    entries.reserve(data.size());
+    for (const auto& [key, value] : data) {
+        Date date;
+        if (!Date::parse(key, date)) return false;
+        entries.emplace_back(date, value);
     }
+    std::sort(entries.begin(), entries.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
 
-    return priceData;
-}
\ No newline at end of file
+    out.clear();
+    out.reserve(entries.size());
+    for (const auto& [date, value] : entries) out.push_back(date, value);
+    return true;
+}
+
+// Method to convert a series back into a date-keyed dictionary
+std::unordered_map<std::string, double> StockUtils::toMap(SeriesView series) {
+    std::unordered_map<std::string, double> data;
+    data.reserve(series.size());
+    for (std::size_t i = 0; i < series.size(); ++i) {
+        data.emplace(series.dateAt(i).toString(), series.valueAt(i));
+    }
+    return data;
+}
@@ -0,0 +1,26 @@
+#include "SymbolTable.hpp"
+
+// Get the id of a symbol, adding it on first use
+SymbolTable::SymbolId SymbolTable::intern(const std::string& symbol) {
+    auto it = ids.find(symbol);
+    if (it != ids.end()) return it->second;
+
+    const SymbolId id = static_cast<SymbolId>(names.size());
+    ids.emplace(symbol, id);
+    names.push_back(symbol);
+    return id;
+}
+
+SymbolTable::SymbolId SymbolTable::id(const std::string& symbol) const {
+    auto it = ids.find(symbol);
+    if (it == ids.end()) throw std::out_of_range("Symbol not in the table: " + symbol);
+    return it->second;
+}
+
+const std::string& SymbolTable::name(SymbolId id) const {
+    return names.at(id);
+}
+
+std::size_t SymbolTable::size() const {
+    return names.size();
+}
@@ -0,0 +1,80 @@
+#include "TextBuffer.hpp"
+#include <charconv>
+
+namespace {
+    // Longest %g output with 6 significant digits, e.g. "-1.23457e-308", and of a 64-bit integer
+    const std::size_t MAX_NUMBER_LENGTH = 32;
+
+    // Helper function to append the to_chars text of a value
+    template <typename... Format>
+    void appendNumber(std::string& text, Format... format) {
+        char digits[MAX_NUMBER_LENGTH];
+        auto result = std::to_chars(digits, digits + MAX_NUMBER_LENGTH, format...);
+        text.append(digits, result.ptr);
+    }
+}
+
+TextBuffer& TextBuffer::operator<<(double value) {
+    appendNumber(text, value, std::chars_format::general, 6);
+    return *this;
+}
+
+TextBuffer& TextBuffer::operator<<(int value) {
+    appendNumber(text, value);
+    return *this;
+}
+
+TextBuffer& TextBuffer::operator<<(long value) {
+    appendNumber(text, value);
+    return *this;
+}
+
+TextBuffer& TextBuffer::operator<<(unsigned long value) {
+    appendNumber(text, value);
+    return *this;
+}
+
+TextBuffer& TextBuffer::operator<<(const std::string& value) {
+    text += value;
+    return *this;
+}
+
+TextBuffer& TextBuffer::operator<<(const char* value) {
+    text += value;
+    return *this;
+}
+
+TextBuffer& TextBuffer::operator<<(char character) {
+    text += character;
+    return *this;
+}
+
+TextBuffer& TextBuffer::operator<<(Date date) {
+    char digits[10];
+    text.append(digits, date.format(digits));
+    return *this;
+}
+
+const std::string& TextBuffer::str() const {
+    return text;
+}
+
+std::string& TextBuffer::str() {
+    return text;
+}
+
+std::size_t TextBuffer::size() const {
+    return text.size();
+}
+
+bool TextBuffer::empty() const {
+    return text.empty();
+}
+
+void TextBuffer::clear() {
+    text.clear();
+}
+
+void TextBuffer::reserve(std::size_t capacity) {
+    text.reserve(capacity);
+}
@@ -0,0 +1,167 @@
+#include "ThreadPool.hpp"
+
+ThreadPool::ThreadPool(unsigned int threadCount) {
+    unsigned int total = resolveThreadCount(threadCount);
+    for (unsigned int worker = 0; worker < total; ++worker) {
+        queues.push_back(std::make_unique<ChunkQueue>());
+    }
+    for (unsigned int worker = 1; worker < total; ++worker) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, worker);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobAvailable.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+unsigned int ThreadPool::size() const {
+    return static_cast<unsigned int>(workers.size()) + 1;
+}
+
+unsigned int ThreadPool::resolveThreadCount(unsigned int requested) {
+    if (requested > 0) return requested;
+    unsigned int hardware = std::thread::hardware_concurrency();
+    return hardware > 0 ? hardware : 1;
+}
+
+double ThreadPool::RunStatistics::utilisation() const {
+    if (wallSeconds <= 0.0 || busySeconds.empty()) return 0.0;
+    double busy = std::accumulate(busySeconds.begin(), busySeconds.end(), 0.0);
+    return std::min(1.0, busy / (wallSeconds * static_cast<double>(busySeconds.size())));
+}
+
+// Add the timing of another loop
+void ThreadPool::RunStatistics::accumulate(const RunStatistics& other) {
+    wallSeconds += other.wallSeconds;
+    if (busySeconds.size() < other.busySeconds.size()) busySeconds.resize(other.busySeconds.size(), 0.0);
+    if (chunksRun.size() < other.chunksRun.size()) chunksRun.resize(other.chunksRun.size(), 0);
+    for (std::size_t worker = 0; worker < other.busySeconds.size(); ++worker) busySeconds[worker] += other.busySeconds[worker];
+    for (std::size_t worker = 0; worker < other.chunksRun.size(); ++worker) chunksRun[worker] += other.chunksRun[worker];
+    steals += other.steals;
+}
+
+const ThreadPool::RunStatistics& ThreadPool::getLastRunStatistics() const {
+    return lastRun;
+}
+
+// Run task(i) for every i in [0, count) across all workers
+void ThreadPool::parallelFor(std::size_t count, const Task& task) {
+    parallelForChunks(count, 1, [&task](std::size_t begin, std::size_t end, unsigned int worker) {
+        for (std::size_t index = begin; index < end; ++index) task(index, worker);
+    });
+}
+
+// Run task over [0, count) in chunks across all workers
+void ThreadPool::parallelForChunks(std::size_t count, std::size_t chunkSize, const ChunkTask& task) {
+    const unsigned int total = size();
+    lastRun = RunStatistics();
+    lastRun.busySeconds.assign(total, 0.0);
+    lastRun.chunksRun.assign(total, 0);
+    if (count == 0) return;
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentTask = &task;
+        taskCount = count;
+        taskChunkSize = chunkSize > 0 ? chunkSize : 1;
+
+        // Deal the chunks out as contiguous shares, one per worker
+        const std::size_t chunks = (count + taskChunkSize - 1) / taskChunkSize;
+        for (unsigned int worker = 0; worker < total; ++worker) {
+            std::lock_guard<std::mutex> queueLock(queues[worker]->mutex);
+            queues[worker]->front = chunks * worker / total;
+            queues[worker]->back = chunks * (worker + 1) / total;
+        }
+
+        activeWorkers = static_cast<unsigned int>(workers.size());
+        firstError = nullptr;
+        stealCount.store(0);
+        generation++;
+    }
+    jobAvailable.notify_all();
+
+    runChunks(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    jobFinished.wait(lock, [this] { return activeWorkers == 0; });
+    currentTask = nullptr;
+    lastRun.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    lastRun.steals = stealCount.load();
+    if (firstError) {
+        std::exception_ptr error = firstError;
+        firstError = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+// Helper function run by every background worker
+void ThreadPool::workerLoop(unsigned int worker) {
+    std::uint64_t seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobAvailable.wait(lock, [&] { return stopping || generation != seenGeneration; });
+            if (stopping) return;
+            seenGeneration = generation;
+        }
+
+        runChunks(worker);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--activeWorkers == 0) jobFinished.notify_one();
+    }
+}
+
+// Helper function to claim and run chunks until the loop is exhausted
+void ThreadPool::runChunks(unsigned int worker) {
+    double busy = 0.0;
+    std::size_t chunksRun = 0;
+    std::size_t chunk;
+    while (takeChunk(worker, chunk)) {
+        const std::size_t begin = chunk * taskChunkSize;
+        const std::size_t end = std::min(taskCount, begin + taskChunkSize);
+        auto chunkStart = std::chrono::steady_clock::now();
+        try {
+            (*currentTask)(begin, end, worker);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!firstError) firstError = std::current_exception();
+        }
+        busy += std::chrono::duration<double>(std::chrono::steady_clock::now() - chunkStart).count();
+        chunksRun++;
+    }
+
+    // Each worker writes only its own slot; the pool's mutex orders these writes before the caller reads them
+    lastRun.busySeconds[worker] = busy;
+    lastRun.chunksRun[worker] = chunksRun;
+}
+
+// Helper function to take the next chunk of the worker's own share, or steal one from another share
+bool ThreadPool::takeChunk(unsigned int worker, std::size_t& chunk) {
+    {
+        ChunkQueue& own = *queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (own.front < own.back) {
+            chunk = own.front++;
+            return true;
+        }
+    }
+
+    const unsigned int total = size();
+    for (unsigned int offset = 1; offset < total; ++offset) {
+        ChunkQueue& victim = *queues[(worker + offset) % total];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.front < victim.back) {
+            chunk = --victim.back;
+            stealCount.fetch_add(1);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,118 @@
+#include "TradingCalendar.hpp"
+
+TradingCalendar::TradingCalendar(std::vector<Date> sessionDates)
+    : sessions(std::move(sessionDates)) {
+    if (!std::is_sorted(sessions.begin(), sessions.end()) ||
+        std::adjacent_find(sessions.begin(), sessions.end()) != sessions.end()) {
+        throw std::invalid_argument("Trading calendar sessions must be sorted and unique.");
+    }
+    if (sessions.empty()) return;
+
+    firstDay = sessions.front();
+    sessionAtOrAfter.resize(static_cast<std::size_t>(sessions.back() - firstDay) + 1);
+    std::int32_t index = 0;
+    for (std::size_t day = 0; day < sessionAtOrAfter.size(); ++day) {
+        if (sessions[static_cast<std::size_t>(index)] < firstDay + static_cast<std::int32_t>(day)) index++;
+        sessionAtOrAfter[day] = index;
+    }
+}
+
+// Build the calendar from the days a reference stock has valid, non-zero data
+TradingCalendar TradingCalendar::fromStock(const Stock& reference, Stock::Field field) {
+    const auto& dates = reference.getDates();
+    const auto& column = reference.getColumn(field);
+    std::vector<Date> sessionDates;
+    sessionDates.reserve(dates.size());
+    for (std::size_t row = 0; row < dates.size(); ++row) {
+        if (!std::isnan(column[row]) && column[row] != 0) sessionDates.push_back(dates[row]);
+    }
+    return TradingCalendar(std::move(sessionDates));
+}
+
+// Build the calendar from weekdays minus holidays
+TradingCalendar TradingCalendar::fromHolidays(Date firstDay, Date lastDay, const std::vector<Date>& holidays) {
+    std::vector<Date> sortedHolidays(holidays);
+    std::sort(sortedHolidays.begin(), sortedHolidays.end());
+
+    std::vector<Date> sessionDates;
+    for (Date day = firstDay; day <= lastDay; ++day) {
+        if (!day.isWeekend() && !std::binary_search(sortedHolidays.begin(), sortedHolidays.end(), day)) {
+            sessionDates.push_back(day);
+        }
+    }
+    return TradingCalendar(std::move(sessionDates));
+}
+
+std::size_t TradingCalendar::size() const { return sessions.size(); }
+bool TradingCalendar::empty() const { return sessions.empty(); }
+const std::vector<Date>& TradingCalendar::getSessions() const { return sessions; }
+Date TradingCalendar::getSession(std::size_t index) const { return sessions.at(index); }
+
+// Map a date to its session index
+std::int32_t TradingCalendar::sessionIndex(Date date) const {
+    if (sessions.empty() || date < firstDay || date > sessions.back()) return NO_SESSION;
+    std::int32_t index = sessionAtOrAfter[static_cast<std::size_t>(date - firstDay)];
+    return sessions[static_cast<std::size_t>(index)] == date ? index : NO_SESSION;
+}
+
+bool TradingCalendar::isSession(Date date) const {
+    return sessionIndex(date) != NO_SESSION;
+}
+
+// Find the first session on or after a date
+std::size_t TradingCalendar::lowerBound(Date date) const {
+    if (sessions.empty() || date <= firstDay) return 0;
+    if (date > sessions.back()) return sessions.size();
+    return static_cast<std::size_t>(sessionAtOrAfter[static_cast<std::size_t>(date - firstDay)]);
+}
+
+// Find the session index range within [startDate, endDate]
+std::pair<std::size_t, std::size_t> TradingCalendar::getRange(Date startDate, Date endDate) const {
+    std::size_t first = lowerBound(startDate);
+    std::size_t last = endDate < startDate ? first : lowerBound(endDate + 1);
+    return {first, std::max(first, last)};
+}
+
+// Step to the next session after a date
+Date TradingCalendar::nextSession(Date date) const {
+    std::size_t index = lowerBound(date + 1);
+    if (index >= sessions.size()) {
+        throw std::out_of_range("No trading session after " + date.toString());
+    }
+    return sessions[index];
+}
+
+// Check that a stock trades on exactly the sessions in a range
+bool TradingCalendar::isAligned(const Stock& stock, Stock::Field field, Date startDate, Date endDate,
+                                std::string* failureReason) const {
+    auto [sessionFirst, sessionLast] = getRange(startDate, endDate);
+    auto [rowFirst, rowLast] = stock.getRange(startDate, endDate);
+    const auto& dates = stock.getDates();
+    const auto& column = stock.getColumn(field);
+
+    // Rows without a value for the field do not count as trading days of the stock
+    std::size_t validRows = 0;
+    for (std::size_t row = rowFirst; row < rowLast; ++row) {
+        if (!std::isnan(column[row])) validRows++;
+    }
+
+    if (validRows == 0 || sessionFirst == sessionLast) {
+        if (failureReason) *failureReason = "One of the stocks has no data in the specified range.";
+        return false;
+    }
+    if (validRows != sessionLast - sessionFirst) {
+        if (failureReason) *failureReason = "The stocks have a different number of dates in the specified range.";
+        return false;
+    }
+
+    std::size_t session = sessionFirst;
+    for (std::size_t row = rowFirst; row < rowLast; ++row) {
+        if (std::isnan(column[row])) continue;
+        if (dates[row] != sessions[session] || column[row] == 0) {
+            if (failureReason) *failureReason = "Mismatch or invalid data on date: " + dates[row].toString();
+            return false;
+        }
+        session++;
+    }
+    return true;
+}
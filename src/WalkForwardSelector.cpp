@@ -0,0 +1,163 @@
+#include "WalkForwardSelector.hpp"
+#include "StockAnalysis.hpp"
+#include <limits>
+
+namespace {
+    // Safety factor on the rounding error bound of the running sums, as in SpreadVarianceMatrix
+    const double ERROR_SAFETY_FACTOR = 16.0;
+}
+
+// Set up the sums of the first window
+WalkForwardSelector::WalkForwardSelector(const PricePanel& panel, std::size_t windowLength, std::size_t recomputeInterval)
+    : panel(&panel), windowLength(windowLength), recomputeInterval(recomputeInterval) {
+    if (windowLength < 2 || windowLength > panel.sessionCount()) {
+        throw std::invalid_argument("The walk-forward window needs between 2 and " + std::to_string(panel.sessionCount()) +
+                                    " sessions, got " + std::to_string(windowLength) + ".");
+    }
+    if (recomputeInterval == 0) {
+        throw std::invalid_argument("The recompute interval must be at least one slide.");
+    }
+    const Eigen::Index symbols = static_cast<Eigen::Index>(panel.symbolCount());
+    entering.resize(symbols);
+    leaving.resize(symbols);
+    spread.resize(static_cast<Eigen::Index>(windowLength));
+    recompute();
+}
+
+// Rebuild the sums of the current window about the window means
+void WalkForwardSelector::recompute() {
+    const Eigen::Index symbols = static_cast<Eigen::Index>(panel->symbolCount());
+    auto window = panel->getPrices().middleRows(static_cast<Eigen::Index>(windowStart), static_cast<Eigen::Index>(windowLength));
+
+    // Centring makes the sums about the shifts as small as they get, which keeps the later updates well conditioned
+    shifts = window.colwise().mean().transpose();
+    Eigen::MatrixXd shifted = window.rowwise() - shifts.transpose();
+    sums = shifted.colwise().sum().transpose();
+    crossProducts = Eigen::MatrixXd::Zero(symbols, symbols);
+    crossProducts.selfadjointView<Eigen::Lower>().rankUpdate(shifted.transpose());
+
+    absoluteMagnitudes = shifted.cwiseAbs().colwise().sum().transpose();
+    squareMagnitudes = crossProducts.diagonal();
+    slidesSinceRecompute = 0;
+}
+
+// Slide the window forward by one session
+bool WalkForwardSelector::advance() {
+    if (windowStart + windowLength >= panel->sessionCount()) return false;
+
+    const Eigen::MatrixXd& prices = panel->getPrices();
+    leaving = prices.row(static_cast<Eigen::Index>(windowStart)).transpose() - shifts;
+    entering = prices.row(static_cast<Eigen::Index>(windowStart + windowLength)).transpose() - shifts;
+    windowStart++;
+
+    if (++slidesSinceRecompute >= recomputeInterval) {
+        recompute();
+        return true;
+    }
+
+    // Add the new session and drop the oldest
+    sums += entering - leaving;
+    crossProducts.selfadjointView<Eigen::Lower>().rankUpdate(entering, 1.0);
+    crossProducts.selfadjointView<Eigen::Lower>().rankUpdate(leaving, -1.0);
+    absoluteMagnitudes += entering.cwiseAbs();
+    squareMagnitudes += entering.cwiseAbs2();
+    return true;
+}
+
+std::size_t WalkForwardSelector::getWindowStart() const {
+    return windowStart;
+}
+
+std::size_t WalkForwardSelector::getWindowLength() const {
+    return windowLength;
+}
+
+Date WalkForwardSelector::getWindowEndDate() const {
+    return panel->getSessions()[windowStart + windowLength - 1];
+}
+
+// Variance of the normalised spread of columns i and j over the current window
+double WalkForwardSelector::spreadVariance(std::size_t i, std::size_t j) const {
+    const Eigen::Index a = static_cast<Eigen::Index>(std::max(i, j)), b = static_cast<Eigen::Index>(std::min(i, j));
+    const Eigen::Index first = static_cast<Eigen::Index>(windowStart);
+    const double n = static_cast<double>(windowLength);
+
+    // Normalising a column to its first value scales its sums by the inverse of that value
+    const double scaleA = 1.0 / panel->getPrices()(first, a), scaleB = 1.0 / panel->getPrices()(first, b);
+    const double secondMoment = (crossProducts(a, a) * scaleA * scaleA + crossProducts(b, b) * scaleB * scaleB
+        - 2.0 * crossProducts(a, b) * scaleA * scaleB) / n;
+    const double mean = (sums(a) * scaleA - sums(b) * scaleB) / n;
+    return secondMoment - mean * mean;
+}
+
+// Bound on the rounding error of spreadVariance
+double WalkForwardSelector::errorBound(std::size_t i, std::size_t j) const {
+    const Eigen::Index a = static_cast<Eigen::Index>(i), b = static_cast<Eigen::Index>(j);
+    const Eigen::Index first = static_cast<Eigen::Index>(windowStart);
+    const double n = static_cast<double>(windowLength);
+    const double scaleA = std::abs(1.0 / panel->getPrices()(first, a)), scaleB = std::abs(1.0 / panel->getPrices()(first, b));
+
+    // Every value added since the last rebuild, dropped ones included, leaves its rounding in the sums
+    const double relativeError = ERROR_SAFETY_FACTOR * (n + 2.0 * static_cast<double>(slidesSinceRecompute))
+        * std::numeric_limits<double>::epsilon();
+    const double secondMomentError = 2.0 * relativeError *
+        (squareMagnitudes(a) * scaleA * scaleA + squareMagnitudes(b) * scaleB * scaleB) / n;
+    const double meanError = relativeError * (absoluteMagnitudes(a) * scaleA + absoluteMagnitudes(b) * scaleB) / n;
+    const double mean = std::abs(sums(a) * scaleA - sums(b) * scaleB) / n;
+    return secondMomentError + (2.0 * mean + meanError) * meanError + std::numeric_limits<double>::min();
+}
+
+// Get a lower bound of the exact spread standard deviation
+double WalkForwardSelector::standardDeviationLowerBound(std::size_t i, std::size_t j) const {
+    double lower = spreadVariance(i, j) - errorBound(i, j);
+    return lower > 0.0 ? std::sqrt(lower) : 0.0;
+}
+
+// Two-pass spread standard deviation over the current window
+double WalkForwardSelector::exactStandardDeviation(std::size_t i, std::size_t j) const {
+    const Eigen::Index first = static_cast<Eigen::Index>(windowStart);
+    const Eigen::Index n = static_cast<Eigen::Index>(windowLength);
+    auto columnA = panel->column(i).segment(first, n);
+    auto columnB = panel->column(j).segment(first, n);
+    spread = columnA.array() / columnA(0) - columnB.array() / columnB(0);
+    return StockAnalysis::calculateStatistics(spread).second;
+}
+
+// Run the greedy pairing on the current window
+std::vector<GreedyPairing::Pair> WalkForwardSelector::selectPairs() const {
+    const Eigen::Index first = static_cast<Eigen::Index>(windowStart);
+    for (std::size_t j = 0; j < panel->symbolCount(); ++j) {
+        if (panel->getPrices()(first, static_cast<Eigen::Index>(j)) == 0) {
+            throw std::runtime_error("The price value on the earliest date is zero, cannot normalize " + panel->getSymbol(j) + ".");
+        }
+    }
+
+    auto lowerBounds = [this](std::size_t base, const std::vector<std::size_t>& candidates, std::vector<double>& bounds) {
+        for (std::size_t k = 0; k < candidates.size(); ++k) {
+            bounds[k] = standardDeviationLowerBound(base, candidates[k]);
+        }
+    };
+    auto exactScore = [this](std::size_t base, std::size_t candidate) {
+        return exactStandardDeviation(base, candidate);
+    };
+    return GreedyPairing::run(panel->symbolCount(), lowerBounds, exactScore);
+}
+
+// Walk the window across the panel, pairing it every rebalanceInterval sessions
+std::vector<WalkForwardSelector::Rebalance> WalkForwardSelector::run(
+    const PricePanel& panel, std::size_t windowLength, std::size_t rebalanceInterval, std::size_t recomputeInterval) {
+    if (rebalanceInterval == 0) {
+        throw std::invalid_argument("The rebalance interval must be at least one session.");
+    }
+
+    WalkForwardSelector selector(panel, windowLength, recomputeInterval);
+    std::vector<Rebalance> rebalances;
+    while (true) {
+        rebalances.push_back({selector.getWindowEndDate(), selector.getWindowStart(), selector.selectPairs()});
+
+        // Stop once the next rebalance date would fall past the end of the panel
+        if (selector.getWindowStart() + windowLength + rebalanceInterval > panel.sessionCount()) break;
+        for (std::size_t step = 0; step < rebalanceInterval; ++step) selector.advance();
+    }
+    return rebalances;
+}
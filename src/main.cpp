@@ -7,6 +7,23 @@
 #include "PairsTradingBackTesting.hpp"
 #include "Config.hpp"
 #include "StatisticalAnalysis.hpp"
+#include "StockDataStore.hpp"
+#include "JobRunner.hpp"
+#include "PairsBackTestDriver.hpp"
+
+// Schema of the columnar copy of the benchmark screen: the text file's columns, with the date range as two dates
+const std::vector<ColumnarTable::Column> SCREEN_COLUMNS = {
+    {"Pair", ColumnarTable::ColumnType::String},
+    {"Start Date", ColumnarTable::ColumnType::Date},
+    {"End Date", ColumnarTable::ColumnType::Date},
+    {"Slope", ColumnarTable::ColumnType::Float64},
+    {"Slope Error", ColumnarTable::ColumnType::Float64},
+    {"DF", ColumnarTable::ColumnType::Int64},
+    {"Test Statistic", ColumnarTable::ColumnType::Float64},
+    {"P-value", ColumnarTable::ColumnType::Float64},
+    {"R-squared", ColumnarTable::ColumnType::Float64},
+    {"Last Difference", ColumnarTable::ColumnType::Float64}
+};
 
 void processPairsForDateRange(
     const std::vector<std::string>& nyseListings,
@@ -16,17 +33,6 @@ void processPairsForDateRange(
     const std::string& endDate,
     const std::string& filename
 ) {
-    // Get pairs statistics for the given date range
-    auto functionOutput = PairsTradingBackTesting::selectPairsForBackTesting(
-        nyseListings,
-        Config::getStockDataDir(),
-        ".txt",
-        benchmarkStock,
-        priceType,
-        startDate,
-        endDate
-    );
-
     // Check if the file already exists
     bool fileExists = std::filesystem::exists(filename);
 
@@ -42,23 +48,114 @@ void processPairsForDateRange(
         outFile << "Pair,Date Range,Slope,Slope Error,Test Statistic,DF,p-value,R-squared,Last Difference\n";
     }
 
-    // Append the data
-    for (const auto& element : functionOutput) {
-        outFile << element.second.pair << ","
-                << element.second.pairDateRange << ","
-                << element.second.slope << ","
-                << element.second.slopeError << ","
-                << element.second.df << ","
-                << element.second.testStatistic << ","
-                << element.second.pValue << ","
-                << element.second.rSquared << ","
-                << element.second.lastDifference << "\n";
+    // Columnar copy of this call's rows; the text file gathers every call, but a columnar table cannot be appended to,
+    // so each date range gets a fresh table named after it
+    std::unique_ptr<ColumnarTable::Writer> columnarRows;
+    Date start, end;
+    if (Config::WRITE_COLUMNAR_RESULTS && Date::parse(startDate, start) && Date::parse(endDate, end)) {
+        std::filesystem::path columnarPath(filename);
+        columnarPath.replace_filename(columnarPath.stem().string() + "_" + startDate + "_" + endDate + Config::COLUMNAR_RESULT_EXTENSION);
+        try {
+            columnarRows = std::make_unique<ColumnarTable::Writer>(columnarPath.string(), SCREEN_COLUMNS);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+        }
     }
 
+    // Screen the pairs for the given date range; rows arrive in order on this thread, so they are formatted into one
+    // buffer that is written out whenever it fills
+    TextBuffer rows;
+    PairsTradingBackTesting::screenAgainstBenchmark(
+        nyseListings,
+        Config::getStockDataDir(),
+        ".txt",
+        benchmarkStock,
+        priceType,
+        startDate,
+        endDate,
+        [&rows, &outFile, &columnarRows, start, end](const PairsTradingBackTesting::LNpairStatistic& element) {
+            rows << element.pair << ","
+                << element.pairDateRange << ","
+                << element.slope << ","
+                << element.slopeError << ","
+                << element.df << ","
+                << element.testStatistic << ","
+                << element.pValue << ","
+                << element.rSquared << ","
+                << element.lastDifference << '\n';
+            if (rows.size() >= Config::RESULT_SINK_BUFFER_SIZE) {
+                outFile << rows.str();
+                rows.clear();
+            }
+
+            if (columnarRows) {
+                columnarRows->addString(element.pair);
+                columnarRows->addDate(start);
+                columnarRows->addDate(end);
+                columnarRows->addDouble(element.slope);
+                columnarRows->addDouble(element.slopeError);
+                columnarRows->addInteger(element.df);
+                columnarRows->addDouble(element.testStatistic);
+                columnarRows->addDouble(element.pValue);
+                columnarRows->addDouble(element.rSquared);
+                columnarRows->addDouble(element.lastDifference);
+                columnarRows->endRow();
+            }
+        },
+        PairsTradingBackTesting::SelectionConfig()
+    );
+
+    outFile << rows.str();
     outFile.close();
+    if (columnarRows && !columnarRows->close()) {
+        std::cerr << "Error: Unable to write the columnar screen results\n";
+    }
+}
+
+// Write the sweep averaged over the pairs, one row per (entry, exit) multiplier
+void writeSweepResults(
+    const std::vector<PairsBackTestDriver::PairSweep>& sweeps,
+    const std::vector<double>& entryMultipliers,
+    const std::vector<double>& exitMultipliers,
+    const std::string& filename
+) {
+    std::ofstream outFile(filename);
+    if (!outFile.is_open()) {
+        std::cerr << "Error: Unable to open file " << filename << "\n";
+        return;
+    }
+    outFile << "Entry Multiplier,Exit Multiplier,Pairs,Mean Rate Return,Mean Trade Count,Mean Max Drawdown,Mean Sharpe Ratio\n";
+
+    const std::size_t gridSize = entryMultipliers.size() * exitMultipliers.size();
+    std::vector<PairsBackTestDriver::PairSummary> totals(gridSize);
+    std::size_t pairCount = 0;
+    for (const auto& pairSweep : sweeps) {
+        if (!pairSweep.succeeded) {
+            std::cerr << "Error processing pair " << pairSweep.pair << ": " << pairSweep.error << "\n";
+            continue;
+        }
+        for (std::size_t g = 0; g < gridSize; ++g) {
+            totals[g].rateReturn += pairSweep.summaries[g].rateReturn;
+            totals[g].tradeCount += pairSweep.summaries[g].tradeCount;
+            totals[g].maxDrawdown += pairSweep.summaries[g].maxDrawdown;
+            totals[g].sharpeRatio += pairSweep.summaries[g].sharpeRatio;
+        }
+        pairCount++;
+    }
+    if (pairCount == 0) return;
+
+    for (std::size_t g = 0; g < gridSize; ++g) {
+        outFile << entryMultipliers[g / exitMultipliers.size()] << ","
+                << exitMultipliers[g % exitMultipliers.size()] << ","
+                << pairCount << ","
+                << totals[g].rateReturn / pairCount << ","
+                << static_cast<double>(totals[g].tradeCount) / pairCount << ","
+                << totals[g].maxDrawdown / pairCount << ","
+                << totals[g].sharpeRatio / pairCount << "\n";
+    }
 }
 
-int main() {
+int main(int argc, char* argv[]) {
 // Creating the vector containing the NYSE stock listings from text file
 const std::string& NYSE_LISTINGS_FILE =  Config::getListingsFilePath();
 std::vector<std::string> nyseListings = FileReader::readNYSEListings(NYSE_LISTINGS_FILE);
@@ -67,6 +164,44 @@ std::vector<std::string> nyseListings = FileReader::readNYSEListings(NYSE_LISTIN
 const std::string& STOCK_BIN_LOCATION = Config::getStockDataDir();
 const std::string& TEXT_EXTENSION = ".txt";
 
+// Optional mode: build the binary data caches for the whole listing and exit
+if (argc > 1 && std::string(argv[1]) == "--warm-cache") {
+    std::size_t written = FileReader::warmCache(NYSE_LISTINGS_FILE, STOCK_BIN_LOCATION, TEXT_EXTENSION);
+    std::cout << "Wrote " << written << " cache files for " << nyseListings.size() << " listings\n";
+    return 0;
+}
+
+// Optional mode: run selection and back-testing for every window of a job file into one result set
+if (argc > 2 && std::string(argv[1]) == "--jobs") {
+    std::vector<JobRunner::Window> windows;
+    try {
+        windows = JobRunner::readJobFile(argv[2]);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    std::size_t rows = JobRunner::run(windows, nyseListings, JobRunner::Settings(),
+        Config::getOutputDir() + "Jobs_Backtesting_Results.txt", Config::getOutputDir() + "Jobs_Backtesting_Results_Trades.txt");
+    std::cout << "Wrote " << rows << " result rows for " << windows.size() << " windows\n";
+    StockDataStore::instance().printStatistics();
+    return 0;
+}
+
+// Optional mode: walk a formation window of the given number of sessions across a date range and write its pairings
+// at every rebalance, e.g. --walk-forward 2022-11-01 2023-11-01 126 21
+if (argc > 5 && std::string(argv[1]) == "--walk-forward") {
+    try {
+        std::size_t rows = JobRunner::runWalkForward(nyseListings, JobRunner::Settings(), argv[2], argv[3],
+            std::stoul(argv[4]), std::stoul(argv[5]), Config::getOutputDir() + "Walk_Forward_Pairings.txt");
+        std::cout << "Wrote " << rows << " pairing rows\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    StockDataStore::instance().printStatistics();
+    return 0;
+}
+
 // Define the start and end date
 const std::string& START_DATE = "2022-11-01", END_DATE = "2023-11-01";
 
@@ -79,68 +214,62 @@ const double PRICE_VOLUME_THRESH = 500000;
 std::map<std::string, PairsTradingBackTesting::PairStatistics> pairs = PairsTradingBackTesting::selectPairsForBackTesting(
     nyseListings, STOCK_BIN_LOCATION, TEXT_EXTENSION, PRICE_TYPE, START_DATE, END_DATE, PRICE_VOLUME_THRESH);
 
-std::ofstream outFile(Config::getOutputDir() + "Pairs_Backtesting_Results.txt");
-outFile << "Pair,Mean,Standard Deviation,P-value,ADF P-value AIC,ADF P-value BIC,PP Short Rho,PP Long Rho,PP Short Tau,PP Long Tau,KPSS Short,KPSS Long," <<
-"Rate Return,Trade Count,Max Drawdown,Sharpe Ratio\n";
-
 // Back-test for all stocks and record the distribution of the percentage change in portfolio
 const std::string& BACK_TEST_START_DATE = "2023-11-02";
 const std::string& BACK_TEST_END_DATE = "2024-05-02";
-for (const auto& [pair, stats] : pairs) {
-    try {
-        size_t delimiterPos = pair.find("-");
-        std::string stock1Name = pair.substr(0, delimiterPos);
-        std::string stock2Name = pair.substr(delimiterPos + 1);
-
-        Stock stock1, stock2;
-        FileReader::loadStockDataFromFile(STOCK_BIN_LOCATION + stock1Name + TEXT_EXTENSION, stock1);
-        FileReader::loadStockDataFromFile(STOCK_BIN_LOCATION + stock2Name + TEXT_EXTENSION, stock2);
-		
-        auto stock1Data = StockUtils::getPriceDataInRange(stock1, PRICE_TYPE, BACK_TEST_START_DATE, BACK_TEST_END_DATE);
-        auto stock2Data = StockUtils::getPriceDataInRange(stock2, PRICE_TYPE, BACK_TEST_START_DATE, BACK_TEST_END_DATE);
-		
-		auto pairSelectionData1 = StockUtils::getPriceDataInRange(stock1, PRICE_TYPE, START_DATE, END_DATE);
-		auto pairSelectionData2 = StockUtils::getPriceDataInRange(stock2, PRICE_TYPE, START_DATE, END_DATE);
-
-		PairsTradingBackTesting backTesting(stock1Name, stock1Data, stock2Name, stock2Data, pairSelectionData1, pairSelectionData2, 1000);
-
-        PairsTradingBackTesting::BackTestingConfig config;
-        config.entryThreshold = 2.0 * stats.standardDeviation;
-        config.exitThreshold = 1.5 * stats.standardDeviation;
-        config.tradeAmount = 100.0;
-		config.slippage = 0;
-
-        backTesting.run(config);
-
-        double rateReturn = 100.0 / backTesting.getInitialBalance() * (backTesting.getCurrentBalance() - backTesting.getInitialBalance()); // Convert to %
-        double sharpeRatio = backTesting.calculateSharpeRatio();
-        double maxDrawdown = backTesting.calculateMaximumDrawdown();
-
-        outFile << pair << ","
-                << stats.mean << ","
-                << stats.standardDeviation << ","
-                << stats.pValue << ","
-                << stats.adfPValueAIC << ","
-                << stats.adfPValueBIC << ","
-                << stats.ppPValueShortRho << ","
-                << stats.ppPValueLongRho << ","
-                << stats.ppPValueShortTau << ","
-                << stats.ppPValueLongTau << ","
-                << stats.kpssPValueShort << ","
-                << stats.kpssPValueLong << ","
-                << rateReturn << ","
-                << backTesting.getTradeCount() << ","
-                << maxDrawdown << ","
-                << sharpeRatio << "\n";
-
-		// Output all trades
-		backTesting.logResults(Config::getOutputDir() + "Pairs_Backtesting_Results_Trades.txt");
+const PairsBackTestDriver::Window window{START_DATE, END_DATE, BACK_TEST_START_DATE, BACK_TEST_END_DATE};
+PairsBackTestDriver::Settings settings;
+settings.stockDataDir = STOCK_BIN_LOCATION;
+settings.fileExtension = TEXT_EXTENSION;
+settings.priceType = PRICE_TYPE;
+
+// Optional mode: sweep the entry and exit multipliers instead of back-testing the fixed 2.0/1.5
+if (argc > 1 && std::string(argv[1]) == "--sweep") {
+    std::vector<double> entryMultipliers, exitMultipliers;
+    for (int i = 1; i <= 50; ++i) {
+        entryMultipliers.push_back(0.1 * i);
+        exitMultipliers.push_back(0.05 * i);
+    }
+    std::vector<PairsBackTestDriver::PairSweep> sweeps = PairsBackTestDriver::sweep(
+        pairs, window, settings, PairsBackTestDriver::thresholdGrid(entryMultipliers, exitMultipliers, 100.0));
+    writeSweepResults(sweeps, entryMultipliers, exitMultipliers, Config::getOutputDir() + "Pairs_Sweep_Results.txt");
+    StockDataStore::instance().printStatistics();
+    return 0;
+}
 
+std::ofstream outFile(Config::getOutputDir() + "Pairs_Backtesting_Results.txt");
+outFile << PairsBackTestDriver::RESULT_HEADER << "\n";
+
+// Output all trades, appending to the trades of earlier runs
+const std::string tradesPath = Config::getOutputDir() + "Pairs_Backtesting_Results_Trades.txt";
+bool tradesHeaderWritten = std::filesystem::exists(tradesPath);
+std::ofstream tradesOut(tradesPath, std::ios::app);
+
+// Columnar copies of this run's results and trades, for reading back without parsing text
+std::unique_ptr<ColumnarTable::Writer> columnarResults, columnarTrades;
+PairsBackTestDriver::ColumnarOutput columnar{window};
+if (Config::WRITE_COLUMNAR_RESULTS) {
+    try {
+        columnarResults = std::make_unique<ColumnarTable::Writer>(
+            Config::getOutputDir() + "Pairs_Backtesting_Results" + Config::COLUMNAR_RESULT_EXTENSION, PairsBackTestDriver::RESULT_COLUMNS);
+        columnarTrades = std::make_unique<ColumnarTable::Writer>(
+            Config::getOutputDir() + "Pairs_Backtesting_Results_Trades" + Config::COLUMNAR_RESULT_EXTENSION, PairsBackTestDriver::TRADE_COLUMNS);
+        columnar.results = columnarResults.get();
+        columnar.trades = columnarTrades.get();
     } catch (const std::exception& e) {
-        std::cerr << "Error processing pair " << pair << ": " << e.what() << "\n";
+        std::cerr << "Error: " << e.what() << "\n";
     }
 }
+
+PairsBackTestDriver::runAndWrite(pairs, window, settings, PairsBackTestDriver::thresholdPolicy(2.0, 1.5, 100.0, 0),
+    outFile, tradesOut, tradesHeaderWritten, "", columnar.results ? &columnar : nullptr);
+tradesOut.close();
 outFile.close();
+if ((columnarResults && !columnarResults->close()) || (columnarTrades && !columnarTrades->close())) {
+    std::cerr << "Error: Unable to write the columnar results\n";
+}
+
+StockDataStore::instance().printStatistics();
 
 return 0;
 }